@@ -0,0 +1,123 @@
+// Compares the packed one-byte Card against the string based card it replaced.
+//
+//   card-bench [iterations]
+//
+// Each test runs the tableau/foundation rule checks over a shuffled deck, the
+// same work the game does for every drop and in checkWin().
+#include "Card.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// The previous Card representation, kept here only as the baseline
+struct LegacyCard {
+    std::string suit;
+    std::string value;
+    bool faceUp;
+
+    int getValue() const {
+        if (value == "ace")
+            return 1;
+        if (value == "jack")
+            return 11;
+        if (value == "queen")
+            return 12;
+        if (value == "king")
+            return 13;
+        return std::stoi(value);
+    }
+
+    bool isRed() const { return suit == "hearts" || suit == "diamonds"; }
+};
+
+bool legacyStacksOnTableau(const LegacyCard& card, const LegacyCard& top) {
+    return card.isRed() != top.isRed() && card.getValue() == top.getValue() - 1;
+}
+
+bool legacyStacksOnFoundation(const LegacyCard& card, const LegacyCard& top) {
+    return card.suit == top.suit && card.getValue() == top.getValue() + 1;
+}
+
+// Keeps the optimizer from discarding the measured work
+volatile long benchSink = 0;
+
+template <typename Fn>
+double nsPerOp(long iterations, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    long hits = 0;
+    for (long i = 0; i < iterations; i++) {
+        hits += fn(i);
+    }
+    auto end = std::chrono::steady_clock::now();
+    benchSink = benchSink + hits;
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+void report(const char* name, double legacyNs, double packedNs) {
+    std::printf("%-22s %10.2f %10.2f %9.1fx\n", name, legacyNs, packedNs, legacyNs / packedNs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    long iterations = argc > 1 ? std::atol(argv[1]) : 10000000;
+    if (iterations <= 0) {
+        std::fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<Card> packed;
+    std::vector<LegacyCard> legacy;
+    for (int i = 0; i < cardDeckSize; i++) {
+        Card card = Card::fromIndex(i);
+        packed.push_back(card);
+    }
+    std::mt19937 rng(12345);
+    std::shuffle(packed.begin(), packed.end(), rng);
+    for (Card card : packed) {
+        legacy.push_back({card.getSuitName(), card.getValueName(), false});
+    }
+
+    const long deckSize = cardDeckSize;
+    std::printf("%-22s %10s %10s %10s\n", "ns/op", "legacy", "packed", "speedup");
+
+    report("getValue",
+        nsPerOp(iterations, [&](long i) { return legacy[i % deckSize].getValue(); }),
+        nsPerOp(iterations, [&](long i) { return packed[i % deckSize].getValue(); }));
+
+    report("isRed",
+        nsPerOp(iterations, [&](long i) { return legacy[i % deckSize].isRed() ? 1 : 0; }),
+        nsPerOp(iterations, [&](long i) { return packed[i % deckSize].isRed() ? 1 : 0; }));
+
+    report("stacksOnTableau",
+        nsPerOp(iterations, [&](long i) { return legacyStacksOnTableau(legacy[i % deckSize], legacy[(i + 7) % deckSize]) ? 1 : 0; }),
+        nsPerOp(iterations, [&](long i) { return Card::stacksOnTableau(packed[i % deckSize], packed[(i + 7) % deckSize]) ? 1 : 0; }));
+
+    report("stacksOnFoundation",
+        nsPerOp(iterations, [&](long i) { return legacyStacksOnFoundation(legacy[i % deckSize], legacy[(i + 7) % deckSize]) ? 1 : 0; }),
+        nsPerOp(iterations, [&](long i) { return Card::stacksOnFoundation(packed[i % deckSize], packed[(i + 7) % deckSize]) ? 1 : 0; }));
+
+    // Copying a full tableau pile, which the game does when a drag starts
+    const long copyIterations = iterations / 10 > 0 ? iterations / 10 : 1;
+    std::vector<LegacyCard> legacyPile;
+    std::vector<Card> packedPile;
+    legacyPile.reserve(13);
+    packedPile.reserve(13);
+    report("copy 13-card pile",
+        nsPerOp(copyIterations, [&](long i) {
+            legacyPile.assign(legacy.begin() + (i % 39), legacy.begin() + (i % 39) + 13);
+            return legacyPile[0].faceUp ? 1 : 0;
+        }),
+        nsPerOp(copyIterations, [&](long i) {
+            packedPile.assign(packed.begin() + (i % 39), packed.begin() + (i % 39) + 13);
+            return packedPile[0].isFaceUp() ? 1 : 0;
+        }));
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+// Measures the undo history on solver solutions.
+//
+//   history-bench [deals]
+//
+// Every solvable deal is played to the end, undone back to the deal and
+// redone again. The piles are compared against snapshots at both ends.
+#include "Solver.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+std::vector<Card> snapshot(const Klondike& game) {
+    std::vector<Card> cards;
+    for (int p = 0; p < PileCount; p++) {
+        cards.insert(cards.end(), game.pile(p).begin(), game.pile(p).end());
+        cards.push_back(Card::fromBits(0));  // Pile separator
+    }
+    return cards;
+}
+
+bool sameCards(const std::vector<Card>& a, const std::vector<Card>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].bits != b[i].bits) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int deals = argc > 1 ? std::atoi(argv[1]) : 200;
+    if (deals <= 0) {
+        std::fprintf(stderr, "usage: %s [deals]\n", argv[0]);
+        return 1;
+    }
+
+    Solver solver(SolverOptions{});
+    Klondike game;
+    int played = 0;
+    int failures = 0;
+    size_t moves = 0;
+    size_t longest = 0;
+    double undoSeconds = 0.0;
+    double redoSeconds = 0.0;
+
+    for (int deal = 1; deal <= deals; deal++) {
+        game.newGame(deal);
+        SolverResult result = solver.solve(game);
+        if (result.status != SolverSolved) {
+            continue;
+        }
+
+        std::vector<Card> start = snapshot(game);
+        for (const Move& move : result.moves) {
+            game.applyMove(move);
+        }
+        std::vector<Card> end = snapshot(game);
+
+        auto t0 = std::chrono::steady_clock::now();
+        while (game.undo()) {
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        bool undone = sameCards(snapshot(game), start);
+        auto t2 = std::chrono::steady_clock::now();
+        while (game.redo()) {
+        }
+        auto t3 = std::chrono::steady_clock::now();
+        bool redone = sameCards(snapshot(game), end) && game.checkWin();
+
+        if (!undone || !redone) {
+            std::fprintf(stderr, "deal %d: history does not restore the %s state\n", deal, undone ? "final" : "initial");
+            failures++;
+        }
+        played++;
+        moves += game.historySize();
+        longest = std::max(longest, game.historySize());
+        undoSeconds += std::chrono::duration<double>(t1 - t0).count();
+        redoSeconds += std::chrono::duration<double>(t3 - t2).count();
+    }
+
+    if (played == 0) {
+        std::fprintf(stderr, "no solvable deal in 1..%d\n", deals);
+        return 1;
+    }
+    std::printf("deals played       %d of %d\n", played, deals);
+    std::printf("bytes per entry    %zu\n", sizeof(HistoryEntry));
+    std::printf("moves per game     %.1f (longest %zu)\n", double(moves) / played, longest);
+    std::printf("500-move history   %zu bytes\n", 500 * sizeof(HistoryEntry));
+    std::printf("undo               %.1f ns/move\n", undoSeconds * 1e9 / moves);
+    std::printf("redo               %.1f ns/move\n", redoSeconds * 1e9 / moves);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,309 @@
+// Microbenchmarks for the rules, move and persistence hot paths, as JSON.
+//
+//   micro-bench [--seed N] [--states N] [--min-time seconds] [-o results.json]
+//
+// Every benchmark runs over the same set of game states: seeded deals played
+// forward by a seeded number of random legal moves. Each result reports
+// ns/op and heap allocations per op, counted by replacing the global
+// operator new, so an engine change can be diffed against a saved baseline.
+#include "AutoPlay.h"
+#include "Klondike.h"
+#include "Random.h"
+#include "SaveFormat.h"
+#include "WinEstimator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Heap allocations made by this process, bumped by the operator new below
+unsigned long long allocationCount = 0;
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    allocationCount++;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    allocationCount++;
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+struct BenchResult {
+    std::string name;
+    unsigned long long iterations;
+    double nsPerOp;
+    double allocsPerOp;
+};
+
+// Keeps the optimizer from discarding the measured work
+volatile long benchSink = 0;
+
+// Doubles the iteration count until one run takes at least minSeconds, then
+// reports that run
+template <typename Fn>
+BenchResult measure(const char* name, double minSeconds, Fn fn) {
+    unsigned long long iterations = 1024;
+    while (true) {
+        unsigned long long allocationsBefore = allocationCount;
+        auto start = std::chrono::steady_clock::now();
+        long hits = 0;
+        for (unsigned long long i = 0; i < iterations; i++) {
+            hits += fn(i);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        unsigned long long allocations = allocationCount - allocationsBefore;
+        benchSink = benchSink + hits;
+        if (seconds >= minSeconds || iterations >= (1ull << 40)) {
+            return {name, iterations, seconds * 1e9 / iterations, double(allocations) / iterations};
+        }
+        iterations *= 2;
+    }
+}
+
+// A legal move in one of the states, for the move benchmark
+struct StateMove {
+    uint32_t state;
+    uint8_t source;
+    uint8_t target;
+    uint8_t startIndex;
+};
+
+// A card and a pile of one state, for the rule checks
+struct StateProbe {
+    uint32_t state;
+    Card card;
+    uint8_t pile;
+};
+
+void collectMoves(const Klondike& game, uint32_t state, std::vector<StateMove>& moves) {
+    for (int source = 0; source < PileCount; source++) {
+        int size = static_cast<int>(game.pile(source).size());
+        for (int start = 0; start < size; start++) {
+            for (int target = 0; target < PileCount; target++) {
+                if (game.canMove(source, start, target)) {
+                    moves.push_back({state, uint8_t(source), uint8_t(target), uint8_t(start)});
+                }
+            }
+        }
+    }
+}
+
+void usage(const char* program) {
+    std::fprintf(stderr, "usage: %s [--seed N] [--states N] [--min-time seconds] [-o results.json]\n", program);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint64_t seed = 1;
+    int stateCount = 256;
+    double minSeconds = 0.2;
+    const char* outputPath = nullptr;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--seed") == 0) {
+            seed = std::strtoull(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--states") == 0) {
+            stateCount = std::atoi(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "--min-time") == 0) {
+            minSeconds = std::atof(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "-o") == 0) {
+            outputPath = argv[i + 1];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (argc % 2 == 0 || stateCount <= 0 || minSeconds <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // Seeded states: a random deal played forward by up to 80 random legal
+    // moves or stock turns
+    Xoshiro256 rng(seed);
+    std::vector<Klondike> states(stateCount);
+    std::vector<StateMove> moves;
+    std::vector<StateProbe> probes;
+    std::vector<Card> deck;
+    for (int s = 0; s < stateCount; s++) {
+        Klondike& game = states[s];
+        game.newGame(static_cast<uint32_t>(rng()));
+        int steps = static_cast<int>(rng.below(81));
+        for (int step = 0; step < steps; step++) {
+            std::vector<StateMove> legal;
+            collectMoves(game, s, legal);
+            if (!legal.empty() && rng.below(3) != 0) {
+                const StateMove& move = legal[rng.below(static_cast<uint32_t>(legal.size()))];
+                game.moveCards(move.source, move.target, move.startIndex);
+            } else if (!game.drawFromStock()) {
+                game.recycleWaste();
+            }
+        }
+        collectMoves(game, s, moves);
+        for (int p = 0; p < PileCount; p++) {
+            for (Card card : game.pile(p)) {
+                if (card.isFaceUp()) {
+                    probes.push_back({uint32_t(s), card, uint8_t(rng.below(PileCount))});
+                }
+            }
+        }
+    }
+    for (int i = 0; i < cardDeckSize; i++) {
+        deck.push_back(Card::fromIndex(i));
+    }
+    if (moves.empty() || probes.empty()) {
+        std::fprintf(stderr, "no legal moves in the generated states\n");
+        return 1;
+    }
+
+    // Rollout inputs for every state; a rollout plays its sampled deal to the end
+    std::vector<RolloutSetup> rolloutSetups(stateCount);
+    for (int s = 0; s < stateCount; s++) {
+        WinEstimator::prepare(states[s], rolloutSetups[s]);
+    }
+    Xoshiro256 rolloutRng(seed);
+
+    // Shuffled pick orders, so the branch predictor cannot learn the sequence
+    const size_t pickMask = 4095;
+    std::vector<uint32_t> movePicks(pickMask + 1), probePicks(pickMask + 1), cardPicks(pickMask + 1);
+    for (size_t i = 0; i <= pickMask; i++) {
+        movePicks[i] = rng.below(static_cast<uint32_t>(moves.size()));
+        probePicks[i] = rng.below(static_cast<uint32_t>(probes.size()));
+        cardPicks[i] = rng.below(cardDeckSize);
+    }
+
+    // Make and undo every move once, so the history vectors have their
+    // capacity before anything is measured
+    for (const StateMove& move : moves) {
+        Klondike& game = states[move.state];
+        if (game.moveCards(move.source, move.target, move.startIndex)) {
+            game.undo();
+        }
+    }
+
+    std::vector<BenchResult> results;
+
+    results.push_back(measure("Card::getValue", minSeconds, [&](unsigned long long i) {
+        return deck[cardPicks[i & pickMask]].getValue();
+    }));
+    results.push_back(measure("Card::isRed", minSeconds, [&](unsigned long long i) {
+        return deck[cardPicks[i & pickMask]].isRed() ? 1 : 0;
+    }));
+    results.push_back(measure("canMoveToTableau", minSeconds, [&](unsigned long long i) {
+        const StateProbe& probe = probes[probePicks[i & pickMask]];
+        const Klondike& game = states[probe.state];
+        return game.canMoveToTableau(probe.card, game.tableau(probe.pile % tableauPileCount)) ? 1 : 0;
+    }));
+    results.push_back(measure("canMoveToFoundation", minSeconds, [&](unsigned long long i) {
+        const StateProbe& probe = probes[probePicks[i & pickMask]];
+        const Klondike& game = states[probe.state];
+        return game.canMoveToFoundation(probe.card, game.foundation(probe.pile % foundationPileCount)) ? 1 : 0;
+    }));
+    results.push_back(measure("findValidFoundationPile", minSeconds, [&](unsigned long long i) {
+        const StateProbe& probe = probes[probePicks[i & pickMask]];
+        return states[probe.state].findValidFoundationPile(probe.card);
+    }));
+    results.push_back(measure("AutoPlay::findSafeMove", minSeconds, [&](unsigned long long i) {
+        int source, target;
+        return AutoPlay::findSafeMove(states[probePicks[i & pickMask] % stateCount], source, target) ? 1 : 0;
+    }));
+    results.push_back(measure("WinEstimator::rollout", minSeconds, [&](unsigned long long i) {
+        return WinEstimator::rollout(rolloutSetups[i % stateCount], rolloutRng) ? 1 : 0;
+    }));
+    results.push_back(measure("checkWin", minSeconds, [&](unsigned long long i) {
+        return states[probePicks[i & pickMask] % stateCount].checkWin() ? 1 : 0;
+    }));
+    // A move cannot be measured alone without the states drifting, so each op
+    // is the move and the undo that restores the state
+    results.push_back(measure("moveCards+undo", minSeconds, [&](unsigned long long i) {
+        const StateMove& move = moves[movePicks[i & pickMask]];
+        Klondike& game = states[move.state];
+        bool moved = game.moveCards(move.source, move.target, move.startIndex);
+        game.undo();
+        return moved ? 1 : 0;
+    }));
+
+    // Dealing and saving use their own game so the states stay untouched
+    Klondike scratch;
+    Card shuffled[cardDeckSize];
+    Klondike::shuffledDeck(static_cast<uint32_t>(seed), shuffled);
+    results.push_back(measure("dealCards", minSeconds, [&](unsigned long long) {
+        scratch.clear();
+        scratch.pile(PileStock).assign(shuffled, shuffled + cardDeckSize);
+        scratch.dealCards();
+        return static_cast<long>(scratch.stock().size());
+    }));
+    results.push_back(measure("newGame", minSeconds, [&](unsigned long long i) {
+        scratch.newGame(static_cast<uint32_t>(i));
+        return static_cast<long>(scratch.stock().size());
+    }));
+
+    SaveImage image;
+    results.push_back(measure("SaveFormat::encode", minSeconds, [&](unsigned long long i) {
+        SaveFormat::encode(states[i % stateCount], image);
+        return static_cast<long>(image.checksum);
+    }));
+    std::vector<SaveImage> images(stateCount);
+    for (int s = 0; s < stateCount; s++) {
+        SaveFormat::encode(states[s], images[s]);
+    }
+    results.push_back(measure("SaveFormat::decode", minSeconds, [&](unsigned long long i) {
+        return SaveFormat::decode(images[i % stateCount], scratch) ? 1 : 0;
+    }));
+
+    // saveGame and loadGame, through the file system
+    std::string savePath = std::string(outputPath ? outputPath : "micro-bench") + ".save.tmp";
+    results.push_back(measure("saveGame", minSeconds, [&](unsigned long long i) {
+        return SaveFormat::write(savePath, states[i % stateCount]) ? 1 : 0;
+    }));
+    results.push_back(measure("loadGame", minSeconds, [&](unsigned long long) {
+        return SaveFormat::read(savePath, scratch) ? 1 : 0;
+    }));
+    std::remove(savePath.c_str());
+
+    FILE* out = outputPath ? std::fopen(outputPath, "w") : stdout;
+    if (!out) {
+        std::fprintf(stderr, "could not write %s\n", outputPath);
+        return 1;
+    }
+    std::fprintf(out, "{\n  \"benchmark\": \"micro-bench\",\n  \"seed\": %llu,\n  \"states\": %d,\n  \"moves\": %zu,\n",
+                 (unsigned long long)seed, stateCount, moves.size());
+    std::fprintf(out, "  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& result = results[i];
+        std::fprintf(out, "    {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.3f, \"allocs_per_op\": %.4f}%s\n",
+                     result.name.c_str(), result.iterations, result.nsPerOp, result.allocsPerOp,
+                     i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    return 0;
+}
@@ -0,0 +1,187 @@
+// Compares the binary save format against the JSON saves it replaced.
+//
+//   save-bench [iterations] [deal]
+//
+// The game state is a deal played halfway through its solver solution so
+// that every pile holds some cards. Both formats go through a real file.
+#include "SaveFormat.h"
+#include "Solver.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace {
+
+const char* legacyPath = "save-bench.txt";
+const char* binaryPath = "save-bench.bin";
+
+// The previous load path built a LegacyCard with string fields and looked up
+// its texture by image path for every card, kept here only as the baseline
+struct LegacyCard {
+    std::string suit;
+    std::string value;
+    bool faceUp;
+    int texture;
+};
+
+std::unordered_map<std::string, int> legacyTextureCache;
+
+std::string legacyValueName(int value) {
+    switch (value) {
+        case 1: return "ace";
+        case 11: return "jack";
+        case 12: return "queen";
+        case 13: return "king";
+        default: return std::to_string(value);
+    }
+}
+
+std::string legacyImagePath(const std::string& suit, const std::string& value) {
+    return "assets/cards/" + value + "_of_" + suit + ".png";
+}
+
+json legacyPileJson(const CardPile& pile) {
+    json pileJson = json::array();
+    for (const auto& card : pile) {
+        json cardJson;
+        cardJson["suit"] = card.getSuitName();
+        cardJson["value"] = card.getValue();
+        cardJson["faceUp"] = card.isFaceUp();
+        pileJson.push_back(cardJson);
+    }
+    return pileJson;
+}
+
+bool legacySave(const Klondike& game) {
+    json gameState;
+    for (int i = 0; i < tableauPileCount; i++) {
+        gameState["tableau"].push_back(legacyPileJson(game.tableau(i)));
+    }
+    for (int i = 0; i < foundationPileCount; i++) {
+        gameState["foundations"].push_back(legacyPileJson(game.foundation(i)));
+    }
+    gameState["stock"] = legacyPileJson(game.stock());
+    gameState["waste"] = legacyPileJson(game.waste());
+
+    std::ofstream file(legacyPath);
+    file << gameState.dump(4);
+    return file.good();
+}
+
+void legacyLoadPile(const json& pileJson, std::vector<LegacyCard>& pile) {
+    for (const auto& cardData : pileJson) {
+        LegacyCard card;
+        card.suit = cardData["suit"].get<std::string>();
+        card.value = legacyValueName(cardData["value"].get<int>());
+        card.faceUp = cardData["faceUp"].get<bool>();
+        auto it = legacyTextureCache.find(legacyImagePath(card.suit, card.value));
+        card.texture = it != legacyTextureCache.end() ? it->second : -1;
+        pile.push_back(card);
+    }
+}
+
+size_t legacyLoad() {
+    std::ifstream file(legacyPath);
+    json gameState;
+    file >> gameState;
+
+    std::vector<LegacyCard> piles[PileCount];
+    for (size_t i = 0; i < gameState["tableau"].size(); i++) {
+        legacyLoadPile(gameState["tableau"][i], piles[PileTableau0 + i]);
+    }
+    for (size_t i = 0; i < gameState["foundations"].size(); i++) {
+        legacyLoadPile(gameState["foundations"][i], piles[PileFoundation0 + i]);
+    }
+    legacyLoadPile(gameState["stock"], piles[PileStock]);
+    legacyLoadPile(gameState["waste"], piles[PileWaste]);
+
+    size_t cards = 0;
+    for (const auto& pile : piles) {
+        cards += pile.size();
+    }
+    return cards;
+}
+
+long fileSize(const char* path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    return file ? static_cast<long>(file.tellg()) : -1;
+}
+
+// Keeps the optimizer from discarding the measured work
+volatile long benchSink = 0;
+
+template <typename Fn>
+double usPerOp(long iterations, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    long hits = 0;
+    for (long i = 0; i < iterations; i++) {
+        hits += fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+    benchSink = benchSink + hits;
+    return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    long iterations = argc > 1 ? std::atol(argv[1]) : 2000;
+    uint32_t deal = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 1;
+    if (iterations <= 0) {
+        std::fprintf(stderr, "usage: %s [iterations] [deal]\n", argv[0]);
+        return 1;
+    }
+
+    for (int i = 0; i < cardDeckSize; i++) {
+        Card card = Card::fromIndex(i);
+        legacyTextureCache[legacyImagePath(card.getSuitName(), legacyValueName(card.getValue()))] = i;
+    }
+
+    Klondike game;
+    game.newGame(deal);
+    Solver solver(SolverOptions{});
+    SolverResult result = solver.solve(game);
+    for (size_t i = 0; i < result.moves.size() / 2; i++) {
+        game.applyMove(result.moves[i]);
+    }
+
+    Klondike loaded;
+    double legacySaveUs = usPerOp(iterations, [&] { return legacySave(game) ? 1 : 0; });
+    double legacyLoadUs = usPerOp(iterations, [&] { return static_cast<int>(legacyLoad()); });
+    double binarySaveUs = usPerOp(iterations, [&] { return SaveFormat::write(binaryPath, game) ? 1 : 0; });
+    double binaryLoadUs = usPerOp(iterations, [&] { return SaveFormat::read(binaryPath, loaded) ? 1 : 0; });
+
+    bool identical = true;
+    for (int p = 0; p < PileCount; p++) {
+        const CardPile& a = game.pile(p);
+        const CardPile& b = loaded.pile(p);
+        identical &= a.size() == b.size();
+        for (size_t i = 0; identical && i < a.size(); i++) {
+            identical &= a[i].bits == b[i].bits;
+        }
+    }
+
+    std::printf("deal %u, %zu of %zu solution moves played, %ld iterations\n", deal, result.moves.size() / 2,
+                result.moves.size(), iterations);
+    std::printf("%-10s %12s %12s %10s\n", "format", "save us", "load us", "bytes");
+    std::printf("%-10s %12.2f %12.2f %10ld\n", "json", legacySaveUs, legacyLoadUs, fileSize(legacyPath));
+    std::printf("%-10s %12.2f %12.2f %10ld\n", "binary", binarySaveUs, binaryLoadUs, fileSize(binaryPath));
+    std::printf("speedup    %11.1fx %11.1fx %9.1fx\n", legacySaveUs / binarySaveUs, legacyLoadUs / binaryLoadUs,
+                double(fileSize(legacyPath)) / fileSize(binaryPath));
+
+    std::remove(legacyPath);
+    std::remove(binaryPath);
+    if (!identical) {
+        std::fprintf(stderr, "binary round trip changed the game state\n");
+        return 1;
+    }
+    return 0;
+}
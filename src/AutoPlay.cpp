@@ -0,0 +1,82 @@
+#include "AutoPlay.h"
+
+namespace {
+
+// Tableau tops and the waste top, the cards that can reach a foundation
+const int candidatePiles[] = {PileWaste, PileTableau0, PileTableau0 + 1, PileTableau0 + 2, PileTableau0 + 3,
+                              PileTableau0 + 4, PileTableau0 + 5, PileTableau0 + 6};
+
+} // namespace
+
+bool AutoPlay::findSafeMove(const Klondike& game, int& sourcePile, int& targetPile) {
+    uint8_t heights[cardSuitCount];
+    game.foundationHeights(heights);
+    for (int pile : candidatePiles) {
+        const CardPile& cards = game.pile(pile);
+        if (cards.empty()) {
+            continue;
+        }
+        Card card = cards.back();
+        if (card.isFaceUp() && heights[card.getSuit()] + 1 == card.getValue() && isSafeFoundationCard(card, heights)) {
+            sourcePile = pile;
+            targetPile = game.findValidFoundationPile(card);
+            return targetPile != noPile;
+        }
+    }
+    return false;
+}
+
+bool AutoPlay::playSafeMove(Klondike& game) {
+    int source, target;
+    if (!findSafeMove(game, source, target)) {
+        return false;
+    }
+    return game.moveCards(source, target, static_cast<int>(game.pile(source).size()) - 1);
+}
+
+bool AutoPlay::canAutoComplete(const Klondike& game) {
+    if (!game.stock().empty()) {
+        return false;
+    }
+    for (int i = 0; i < tableauPileCount; i++) {
+        const CardPile& pile = game.tableau(i);
+        // Face-down cards are only ever at the bottom of a column
+        if (!pile.empty() && !pile[0].isFaceUp()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool AutoPlay::playStep(Klondike& game, bool& completing) {
+    completing = completing || canAutoComplete(game);
+    if (completing) {
+        completing = playCompletionMove(game);
+        return completing;
+    }
+    return playSafeMove(game);
+}
+
+bool AutoPlay::playCompletionMove(Klondike& game) {
+    if (game.checkWin()) {
+        return false;
+    }
+    // The lowest card still missing from the foundations is always on top of
+    // a column or in the talon, so one pass through the talon finds a move
+    for (int turn = 0; turn <= 2 * cardDeckSize; turn++) {
+        for (int pile : candidatePiles) {
+            const CardPile& cards = game.pile(pile);
+            if (cards.empty()) {
+                continue;
+            }
+            int target = game.findValidFoundationPile(cards.back());
+            if (target != noPile) {
+                return game.moveCards(pile, target, static_cast<int>(cards.size()) - 1);
+            }
+        }
+        if (!game.drawFromStock() && !game.recycleWaste()) {
+            return false;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "Klondike.h"
+
+// Moves the game can make for the player. Each move goes through the engine
+// like a player move, so it is recorded, journaled and can be undone.
+//
+// Safe moves are foundation moves that can never be needed back on the
+// tableau (isSafeFoundationCard). Checking one costs a few table lookups, so
+// the front end looks for one after every move. Once the stock is empty and
+// every tableau card is face up, plain play wins, and auto-complete finishes
+// the game with any foundation move, drawing through the waste when none is
+// on top.
+class AutoPlay {
+public:
+    // Finds a safe foundation move for a tableau or waste top card
+    static bool findSafeMove(const Klondike& game, int& sourcePile, int& targetPile);
+    // Applies one safe move, returns false if there is none
+    static bool playSafeMove(Klondike& game);
+
+    // The stock is empty and no tableau card is face down
+    static bool canAutoComplete(const Klondike& game);
+    // Applies the next foundation move of auto-complete, drawing through the
+    // talon first when no top card fits. Returns false once the game is won.
+    static bool playCompletionMove(Klondike& game);
+
+    // One step of auto-play, as the front end runs it once per frame. The
+    // first time canAutoComplete() holds, completing is latched, because the
+    // recycles auto-complete makes refill the stock; the caller clears it
+    // when the player undoes or starts another game. Returns false when there
+    // is nothing left to play.
+    static bool playStep(Klondike& game, bool& completing);
+};
@@ -0,0 +1,264 @@
+#include "BatchAnalyzer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const uint32_t chunkSize = 16;           // Seeds taken from the own slice at a time
+const size_t flushRecords = 1024;        // Records buffered per worker before writing
+
+uint64_t packRange(uint32_t begin, uint32_t end) { return (uint64_t(end) << 32) | begin; }
+uint32_t rangeBegin(uint64_t range) { return static_cast<uint32_t>(range); }
+uint32_t rangeEnd(uint64_t range) { return static_cast<uint32_t>(range >> 32); }
+
+template <typename T>
+uint32_t saturate32(T value) { return value > T(UINT32_MAX) ? UINT32_MAX : static_cast<uint32_t>(value); }
+
+// Per-worker state, padded so that no two workers share a cache line
+struct alignas(64) Worker {
+    std::atomic<uint64_t> range{0};  // [begin, end) offsets into the seed range
+    std::atomic<uint64_t> done{0};
+    uint64_t solved = 0;
+    uint64_t unsolvable = 0;
+    uint64_t budgetExceeded = 0;
+    uint64_t nodes = 0;
+    std::atomic<bool> writeFailed{false};
+};
+
+// Takes up to chunkSize offsets from the front of the worker's own slice
+bool takeFront(Worker& worker, uint32_t& begin, uint32_t& end) {
+    uint64_t range = worker.range.load(std::memory_order_relaxed);
+    while (true) {
+        uint32_t b = rangeBegin(range), e = rangeEnd(range);
+        if (b >= e) {
+            return false;
+        }
+        uint32_t n = std::min(chunkSize, e - b);
+        if (worker.range.compare_exchange_weak(range, packRange(b + n, e), std::memory_order_acq_rel)) {
+            begin = b;
+            end = b + n;
+            return true;
+        }
+    }
+}
+
+// Takes the back half of the victim's slice
+bool stealHalf(Worker& victim, uint32_t& begin, uint32_t& end) {
+    uint64_t range = victim.range.load(std::memory_order_relaxed);
+    while (true) {
+        uint32_t b = rangeBegin(range), e = rangeEnd(range);
+        if (b >= e) {
+            return false;
+        }
+        uint32_t mid = b + (e - b) / 2;
+        if (victim.range.compare_exchange_weak(range, packRange(b, mid), std::memory_order_acq_rel)) {
+            begin = mid;
+            end = e;
+            return true;
+        }
+    }
+}
+
+bool stealWork(std::vector<std::unique_ptr<Worker>>& workers, size_t self) {
+    while (true) {
+        // Pick the worker with the most work left
+        size_t victim = self;
+        uint32_t largest = 0;
+        for (size_t i = 0; i < workers.size(); i++) {
+            uint64_t range = workers[i]->range.load(std::memory_order_relaxed);
+            uint32_t left = rangeEnd(range) > rangeBegin(range) ? rangeEnd(range) - rangeBegin(range) : 0;
+            if (i != self && left > largest) {
+                largest = left;
+                victim = i;
+            }
+        }
+        if (victim == self) {
+            return false;
+        }
+        uint32_t begin, end;
+        if (stealHalf(*workers[victim], begin, end)) {
+            workers[self]->range.store(packRange(begin, end), std::memory_order_release);
+            return true;
+        }
+    }
+}
+
+class RecordWriter {
+public:
+    RecordWriter(const std::string& path) : stream(path, std::ios::in | std::ios::out | std::ios::binary), firstIndex(0) {
+        buffer.reserve(flushRecords);
+    }
+
+    bool good() const { return stream.good(); }
+
+    void add(uint32_t index, const AnalyzerRecord& record) {
+        if (!buffer.empty() && (index != firstIndex + buffer.size() || buffer.size() == flushRecords)) {
+            flush();
+        }
+        if (buffer.empty()) {
+            firstIndex = index;
+        }
+        buffer.push_back(record);
+    }
+
+    bool flush() {
+        if (!buffer.empty()) {
+            std::streamoff offset = sizeof(AnalyzerFileHeader) + std::streamoff(firstIndex) * sizeof(AnalyzerRecord);
+            stream.seekp(offset);
+            stream.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(AnalyzerRecord));
+            buffer.clear();
+        }
+        stream.flush();
+        return stream.good();
+    }
+
+private:
+    std::fstream stream;
+    std::vector<AnalyzerRecord> buffer;
+    uint32_t firstIndex;
+};
+
+} // namespace
+
+BatchAnalyzer::BatchAnalyzer(const AnalyzerOptions& options) : options(options) {}
+
+bool BatchAnalyzer::readHeader(const std::string& path, AnalyzerFileHeader& header) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return false;
+    }
+    return header.magic == analyzerFileMagic && header.version == analyzerFileVersion &&
+           header.recordSize == sizeof(AnalyzerRecord);
+}
+
+bool BatchAnalyzer::run(AnalyzerSummary& summary) {
+    auto start = std::chrono::steady_clock::now();
+
+    unsigned threadCount = options.threads ? options.threads : std::thread::hardware_concurrency();
+    threadCount = std::max(1u, std::min<unsigned>(threadCount, std::max<uint32_t>(options.count, 1)));
+
+    // Write the header; the workers fill in the records at their offsets
+    {
+        std::ofstream file(options.outputPath, std::ios::binary | std::ios::trunc);
+        AnalyzerFileHeader header = {analyzerFileMagic, analyzerFileVersion, sizeof(AnalyzerRecord),
+                                     options.firstSeed, options.count, options.solver.nodeBudget,
+                                     static_cast<uint8_t>(options.drawCount), {}};
+        if (!file.write(reinterpret_cast<const char*>(&header), sizeof(header))) {
+            return false;
+        }
+    }
+
+    // Split the range evenly, stealing evens out the long solves
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (unsigned i = 0; i < threadCount; i++) {
+        workers.emplace_back(new Worker());
+        uint32_t begin = static_cast<uint32_t>(uint64_t(options.count) * i / threadCount);
+        uint32_t end = static_cast<uint32_t>(uint64_t(options.count) * (i + 1) / threadCount);
+        workers[i]->range.store(packRange(begin, end));
+    }
+
+    // Instantiated per rule set, so the solver loop has no variant checks
+    auto work = [&](size_t self, auto rules) {
+        typedef decltype(rules) Rules;
+        Worker& worker = *workers[self];
+        RecordWriter writer(options.outputPath);
+        if (!writer.good()) {
+            worker.writeFailed = true;
+            return;
+        }
+        BasicSolver<Rules> solver(options.solver);
+        BasicKlondike<Rules> game;
+
+        uint32_t begin, end;
+        while (true) {
+            if (!takeFront(worker, begin, end)) {
+                // Out of own work: refill from another worker or finish
+                if (!stealWork(workers, self)) {
+                    break;
+                }
+                continue;
+            }
+            for (uint32_t i = begin; i < end; i++) {
+                uint32_t seed = options.firstSeed + i;
+                game.newGame(seed);
+                SolverResult result = solver.solve(game);
+
+                AnalyzerRecord record;
+                record.seed = seed;
+                record.status = result.status;
+                record.flags = AnalyzerRecord::presentFlag;
+                record.solutionLength = static_cast<uint16_t>(std::min<size_t>(result.moves.size(), UINT16_MAX));
+                record.nodes = saturate32(result.nodes);
+                record.micros = saturate32(result.seconds * 1e6);
+                writer.add(i, record);
+
+                worker.nodes += result.nodes;
+                switch (result.status) {
+                    case SolverSolved: worker.solved++; break;
+                    case SolverUnsolvable: worker.unsolvable++; break;
+                    default: worker.budgetExceeded++; break;
+                }
+                worker.done.store(worker.done.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+        }
+        if (!writer.flush()) {
+            worker.writeFailed = true;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < threadCount; i++) {
+        threads.emplace_back([&work, i, this] {
+            if (options.drawCount == 3) {
+                work(i, DrawThreeRules());
+            } else {
+                work(i, DrawOneRules());
+            }
+        });
+    }
+
+    // Report progress while the workers run
+    if (options.progress) {
+        uint64_t total = options.count;
+        uint64_t done = 0;
+        while (done < total) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            done = 0;
+            bool failed = false;
+            for (auto& worker : workers) {
+                done += worker->done.load(std::memory_order_relaxed);
+                failed |= worker->writeFailed;
+            }
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::fprintf(stderr, "\r%llu/%llu deals  %.0f deals/s ", (unsigned long long)done, (unsigned long long)total,
+                         elapsed > 0 ? done / elapsed : 0.0);
+            if (failed) {
+                break;
+            }
+        }
+        std::fprintf(stderr, "\n");
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    bool ok = true;
+    summary = AnalyzerSummary();
+    summary.threads = threadCount;
+    for (auto& worker : workers) {
+        summary.solved += worker->solved;
+        summary.unsolvable += worker->unsolvable;
+        summary.budgetExceeded += worker->budgetExceeded;
+        summary.nodes += worker->nodes;
+        ok &= !worker->writeFailed;
+    }
+    summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return ok;
+}
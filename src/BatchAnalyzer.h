@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "Solver.h"
+
+// Result file layout, little endian:
+//   AnalyzerFileHeader
+//   AnalyzerRecord[count], record i describes seed firstSeed + i
+// Records are written in place by the workers as they finish, so the file is
+// usable (with missing records zeroed) even if a run is interrupted.
+const uint32_t analyzerFileMagic = 0x4E414C4B;  // "KLAN"
+const uint16_t analyzerFileVersion = 2;  // 2 added drawCount
+
+struct AnalyzerFileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+    uint32_t firstSeed;
+    uint32_t count;
+    uint64_t nodeBudget;
+    uint8_t drawCount;  // Cards per stock turn the deals were solved with
+    uint8_t reserved[7];
+};
+
+struct AnalyzerRecord {
+    static const uint8_t presentFlag = 1;
+
+    uint32_t seed;
+    uint8_t status;          // SolverStatus
+    uint8_t flags;           // presentFlag once the seed has been analyzed
+    uint16_t solutionLength; // Number of moves in the solution, saturated
+    uint32_t nodes;          // Saturated
+    uint32_t micros;         // Solve time, saturated
+};
+
+static_assert(sizeof(AnalyzerFileHeader) == 32, "AnalyzerFileHeader layout changed");
+static_assert(sizeof(AnalyzerRecord) == 16, "AnalyzerRecord layout changed");
+
+struct AnalyzerOptions {
+    uint32_t firstSeed = 1;
+    uint32_t count = 1000;
+    unsigned threads = 0;    // 0 uses every hardware thread
+    int drawCount = 1;       // 1 or 3, picks the rules the solver plays by
+    SolverOptions solver;
+    std::string outputPath = "analysis.bin";
+    bool progress = true;    // Print progress lines to stderr
+};
+
+struct AnalyzerSummary {
+    uint64_t solved = 0;
+    uint64_t unsolvable = 0;
+    uint64_t budgetExceeded = 0;
+    uint64_t nodes = 0;
+    double seconds = 0.0;
+    unsigned threads = 0;
+};
+
+// Deals every seed of a range with Klondike::newGame(), the same deal the game
+// shows for that seed, and solves them on a pool of worker threads.
+//
+// Each worker owns a contiguous slice of the range held in one atomic word.
+// Workers take small chunks from the front of their own slice and, once it is
+// empty, steal the back half of the largest remaining slice. There is no lock
+// anywhere on the hot path: results go straight to their fixed offset in the
+// output file through a per-worker stream.
+class BatchAnalyzer {
+public:
+    explicit BatchAnalyzer(const AnalyzerOptions& options);
+
+    // Returns false if the output file could not be written
+    bool run(AnalyzerSummary& summary);
+
+    static bool readHeader(const std::string& path, AnalyzerFileHeader& header);
+
+private:
+    AnalyzerOptions options;
+};
@@ -0,0 +1,171 @@
+#include "BoardLayout.h"
+#include <algorithm>
+
+namespace {
+
+const float boardLeft = 50;
+const float foundationTop = 10 + baseMenuHeight;
+const float tableauTop = 130 + baseMenuHeight;
+const float bottomRowTop = baseWindowHeight - baseCardHeight - 20;
+const float stockOffset = 2;  // Shift between the cards of the stock stack
+
+// Same edges as raylib's CheckCollisionPointRec
+bool inside(float px, float py, float left, float top, float width, float height) {
+    return px >= left && px < left + width && py >= top && py < top + height;
+}
+
+} // namespace
+
+BoardLayout::BoardLayout() : version(0), valid(false) {
+    for (int i = 0; i < tableauPileCount; i++) {
+        pileX[PileTableau0 + i] = boardLeft + i * baseTableauSpacing;
+        pileY[PileTableau0 + i] = tableauTop;
+    }
+    for (int i = 0; i < foundationPileCount; i++) {
+        pileX[PileFoundation0 + i] = boardLeft + i * baseTableauSpacing;
+        pileY[PileFoundation0 + i] = foundationTop;
+    }
+    pileX[PileStock] = boardLeft;
+    pileY[PileStock] = bottomRowTop;
+    pileX[PileWaste] = boardLeft + baseTableauSpacing;
+    pileY[PileWaste] = bottomRowTop;
+    std::fill(first, first + PileCount, 0);
+    std::fill(count, count + PileCount, 0);
+    std::fill(faceUpStart, faceUpStart + PileCount, 0);
+    std::fill(pileSize, pileSize + PileCount, 0);
+}
+
+bool BoardLayout::update(const Klondike& game) {
+    if (valid && version == game.getStateVersion()) {
+        return false;
+    }
+
+    int entry = 0;
+    for (int p = 0; p < PileCount; p++) {
+        const CardPile& pile = game.pile(p);
+        int size = static_cast<int>(pile.size());
+        int shown = size;
+        if (isFoundationPile(p)) {
+            shown = std::min(size, 2);
+        } else if (p == PileStock) {
+            shown = std::min(size, maxStockShown);
+        } else if (p == PileWaste) {
+            shown = std::min(size, 1);
+        }
+        first[p] = static_cast<uint8_t>(entry);
+        count[p] = static_cast<uint8_t>(shown);
+        pileSize[p] = static_cast<uint8_t>(size);
+
+        if (isTableauPile(p)) {
+            int faceUp = 0;
+            while (faceUp < size && !pile[faceUp].isFaceUp()) {
+                faceUp++;
+            }
+            faceUpStart[p] = static_cast<uint8_t>(faceUp);
+            for (int j = 0; j < size; j++, entry++) {
+                x[entry] = pileX[p];
+                y[entry] = pileY[p] + j * baseCardSpacing;
+                cards[entry] = pile[j];
+            }
+        } else if (p == PileStock) {
+            // Drawn top card first, each deeper card a little further down
+            // and right, as the stack always has been
+            for (int j = 0; j < shown; j++, entry++) {
+                x[entry] = pileX[p] + j * stockOffset;
+                y[entry] = pileY[p] + j * stockOffset;
+                cards[entry] = pile[size - 1 - j];
+            }
+        } else {
+            // Foundation and waste: the top cards, bottom first
+            for (int j = size - shown; j < size; j++, entry++) {
+                x[entry] = pileX[p];
+                y[entry] = pileY[p];
+                cards[entry] = pile[j];
+            }
+        }
+    }
+
+    version = game.getStateVersion();
+    valid = true;
+    return true;
+}
+
+int BoardLayout::column(float px) const {
+    float offset = px - boardLeft;
+    if (offset < 0) {
+        return -1;
+    }
+    int c = static_cast<int>(offset / baseTableauSpacing);
+    return offset - c * baseTableauSpacing < baseCardWidth ? c : -1;
+}
+
+bool BoardLayout::slotContains(int pile, float px, float py) const {
+    return inside(px, py, pileX[pile], pileY[pile], baseCardWidth, baseCardHeight);
+}
+
+int BoardLayout::pileAt(float px, float py) const {
+    int c = column(px);
+
+    // Tableau: the face-up cards overlap, so together they cover one strip
+    if (c >= 0 && c < tableauPileCount) {
+        int p = PileTableau0 + c;
+        int size = pileSize[p];
+        if (size == 0) {
+            if (slotContains(p, px, py)) {
+                return p;
+            }
+        } else if (faceUpStart[p] < size) {
+            float top = pileY[p] + faceUpStart[p] * baseCardSpacing;
+            float bottom = pileY[p] + (size - 1) * baseCardSpacing + baseCardHeight;
+            if (py >= top && py < bottom) {
+                return p;
+            }
+        }
+    }
+
+    // Empty and non-empty foundation piles share the same rectangle
+    if (c >= 0 && c < foundationPileCount && slotContains(PileFoundation0 + c, px, py)) {
+        return PileFoundation0 + c;
+    }
+    if (slotContains(PileStock, px, py)) {
+        return PileStock;
+    }
+    if (slotContains(PileWaste, px, py)) {
+        return PileWaste;
+    }
+    return noPile;
+}
+
+bool BoardLayout::cardAt(float px, float py, int& pile, int& index) const {
+    int c = column(px);
+
+    // The row under the point, or the last card whose full face extends below
+    if (c >= 0 && c < tableauPileCount) {
+        int p = PileTableau0 + c;
+        int size = pileSize[p];
+        if (size > 0 && py >= pileY[p]) {
+            int row = std::min(static_cast<int>((py - pileY[p]) / baseCardSpacing), size - 1);
+            if (row >= faceUpStart[p] && py < pileY[p] + row * baseCardSpacing + baseCardHeight) {
+                pile = p;
+                index = row;
+                return true;
+            }
+        }
+    }
+
+    if (c >= 0 && c < foundationPileCount) {
+        int p = PileFoundation0 + c;
+        if (pileSize[p] > 0 && slotContains(p, px, py)) {
+            pile = p;
+            index = pileSize[p] - 1;
+            return true;
+        }
+    }
+
+    if (pileSize[PileWaste] > 0 && slotContains(PileWaste, px, py)) {
+        pile = PileWaste;
+        index = pileSize[PileWaste] - 1;
+        return true;
+    }
+    return false;
+}
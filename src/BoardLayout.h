@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include "Card.h"
+#include "Klondike.h"
+
+// Base dimensions (unscaled)
+const int baseCardWidth = 71;
+const int baseCardHeight = 96;
+const int baseCardSpacing = 20;
+const int baseTableauSpacing = 100;
+const int baseWindowWidth = 800;
+const int baseWindowHeight = 600;
+const int baseMenuHeight = 30;
+
+// Where every visible card is drawn, in base window coordinates.
+//
+// update() rebuilds the layout only when the Klondike state version changed.
+// The cards go into flat arrays, one contiguous run per pile in drawing order,
+// which the renderer walks front to back. Hit-testing finds the column and row
+// arithmetically, so it is O(1) per pile instead of a rectangle test per card.
+//
+// Visible cards per pile: the whole tableau, the top two foundation cards (the
+// second shows while the top one is dragged), the top five stock cards and
+// the top waste card.
+class BoardLayout {
+public:
+    static const int maxStockShown = 5;
+
+    BoardLayout();
+
+    // Returns true if the layout was rebuilt
+    bool update(const Klondike& game);
+    void invalidate() { valid = false; }
+
+    // Top-left corner of the pile's slot, where an empty pile is drawn
+    float slotX(int pile) const { return pileX[pile]; }
+    float slotY(int pile) const { return pileY[pile]; }
+
+    // Visible cards of a pile are entries [firstEntry, firstEntry + entryCount).
+    // For the tableau, entry firstEntry + i is pile card i.
+    int firstEntry(int pile) const { return first[pile]; }
+    int entryCount(int pile) const { return count[pile]; }
+    float entryX(int entry) const { return x[entry]; }
+    float entryY(int entry) const { return y[entry]; }
+    Card entryCard(int entry) const { return cards[entry]; }
+
+    // PileId a drop at (px, py) goes to: a face-up tableau card or an empty
+    // tableau slot, then the foundation, stock and waste slots. noPile if none.
+    int pileAt(float px, float py) const;
+    // Card a drag starting at (px, py) picks up: a face-up tableau card, then
+    // the top foundation or waste card. Returns false if there is none.
+    bool cardAt(float px, float py, int& pile, int& index) const;
+    // Whether (px, py) is inside the slot rectangle of pile
+    bool slotContains(int pile, float px, float py) const;
+
+private:
+    float pileX[PileCount];
+    float pileY[PileCount];
+    uint8_t first[PileCount];
+    uint8_t count[PileCount];
+    uint8_t faceUpStart[PileCount];  // Index of the first face-up card, tableau only
+    uint8_t pileSize[PileCount];
+    float x[cardDeckSize];
+    float y[cardDeckSize];
+    Card cards[cardDeckSize];
+    uint32_t version;
+    bool valid;
+
+    int column(float px) const;  // Slot column under px, or -1 between columns
+};
@@ -1,51 +1,89 @@
 #pragma once
-#include <raylib.h>
-#include <string>
-#include <unordered_map>
-#include <vector>
-#include <thread>
-#include <future>
-
-// Forward declarations
-class Solitaire;
-
-class Card {
-private:
-    std::string suit;
-    std::string value;
-    Texture2D image;
-    Rectangle rect;
-    bool faceUp;
-    static Texture2D cardBack;  // Static member for card back texture
-    static std::unordered_map<std::string, Texture2D> textureCache;  // Cache for card textures
-    static bool texturesLoaded;  // Flag to track if textures are pre-loaded
-
-    // Helper function to load a single texture
-    static void loadTexture(const std::string& imagePath);
-
-public:
-    static bool isMobile;  // Flag to track if running on mobile device
-
-    Card(const std::string& suit, const std::string& value, const std::string& imagePath);
-    Card(const Card& other);  // Copy constructor
-    Card& operator=(const Card& other);  // Assignment operator
-    ~Card();
-
-    void flip();
-    int getValue() const;
-    bool isRed() const;
-    const std::string& getSuit() const { return suit; }
-    bool isFaceUp() const { return faceUp; }
-    const Rectangle& getRect() const { return rect; }
-    const Texture2D& getImage() const { return image; }
-    void setPosition(float x, float y);
-    void draw() const;
-
-    static void loadCardBack(const std::string& imagePath);
-    static void unloadCardBack();
-    static void unloadAllTextures();
-    static void preloadTextures();  // New function to pre-load all textures
-    static bool areTexturesLoaded() { return texturesLoaded; }  // Check if textures are loaded
-    static float getLoadingProgress();
-    static void setIsMobile(int value) { isMobile = value != 0; }
-}; 
\ No newline at end of file
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Suits in deck order. Hearts and diamonds come first so that the colour of a
+// card is just bit 1 of its suit.
+enum CardSuit : uint8_t {
+    SuitHearts = 0,
+    SuitDiamonds = 1,
+    SuitClubs = 2,
+    SuitSpades = 3
+};
+
+const int cardSuitCount = 4;
+const int cardRankCount = 13;
+const int cardDeckSize = cardSuitCount * cardRankCount;
+
+// Lookup tables used for asset paths and save files
+constexpr const char* cardSuitNames[cardSuitCount] = {"hearts", "diamonds", "clubs", "spades"};
+constexpr const char* cardRankNames[cardRankCount + 1] = {
+    "", "ace", "2", "3", "4", "5", "6", "7", "8", "9", "10", "jack", "queen", "king"};
+constexpr bool cardSuitIsRed[cardSuitCount] = {true, true, false, false};
+
+// A playing card packed into a single byte:
+//   bits 0-3  rank, 1 (ace) to 13 (king); 0 means "no card"
+//   bits 4-5  suit (CardSuit)
+//   bit  6    face up
+// Textures and screen positions are owned by CardRenderer and the layout code,
+// so copying a card is a one byte copy.
+struct Card {
+    static constexpr uint8_t rankMask = 0x0F;
+    static constexpr uint8_t suitMask = 0x30;
+    static constexpr uint8_t colorMask = 0x20;  // Set for black suits
+    static constexpr uint8_t faceUpMask = 0x40;
+    static constexpr int suitShift = 4;
+
+    uint8_t bits;
+
+    Card() = default;
+    constexpr Card(CardSuit suit, int value, bool faceUp = false)
+        : bits(static_cast<uint8_t>((value & rankMask) | (suit << suitShift) | (faceUp ? faceUpMask : 0))) {}
+
+    static constexpr Card fromBits(uint8_t bits) { return Card(static_cast<CardSuit>((bits & suitMask) >> suitShift), bits & rankMask, (bits & faceUpMask) != 0); }
+
+    void flip() { bits ^= faceUpMask; }
+    void setFaceUp(bool faceUp) { bits = static_cast<uint8_t>((bits & ~faceUpMask) | (faceUp ? faceUpMask : 0)); }
+
+    constexpr int getValue() const { return bits & rankMask; }
+    constexpr CardSuit getSuit() const { return static_cast<CardSuit>((bits & suitMask) >> suitShift); }
+    constexpr bool isRed() const { return (bits & colorMask) == 0; }
+    constexpr bool isFaceUp() const { return (bits & faceUpMask) != 0; }
+
+    // 0..51 in suit-major order, used to index per-card tables such as textures
+    constexpr int getIndex() const { return ((bits & suitMask) >> suitShift) * cardRankCount + (bits & rankMask) - 1; }
+    // Card identity without the face-up flag
+    constexpr uint8_t getId() const { return bits & (rankMask | suitMask); }
+
+    const char* getSuitName() const { return cardSuitNames[getSuit()]; }
+    const char* getValueName() const { return cardRankNames[getValue()]; }
+
+    // Returns -1 if the name is not a known suit
+    static int suitFromName(const char* name) {
+        for (int i = 0; i < cardSuitCount; i++) {
+            if (std::strcmp(name, cardSuitNames[i]) == 0) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    static constexpr Card fromIndex(int index) { return Card(static_cast<CardSuit>(index / cardRankCount), index % cardRankCount + 1); }
+
+    // Rule helpers shared by the game and the tools. They compare raw bits so
+    // they compile down to a couple of ALU ops without branches.
+    static constexpr bool oppositeColors(Card a, Card b) { return ((a.bits ^ b.bits) & colorMask) != 0; }
+    static constexpr bool sameSuit(Card a, Card b) { return ((a.bits ^ b.bits) & suitMask) == 0; }
+    static constexpr bool stacksOnTableau(Card card, Card top) {
+        return oppositeColors(card, top) & (card.getValue() + 1 == top.getValue());
+    }
+    static constexpr bool stacksOnFoundation(Card card, Card top) {
+        return sameSuit(card, top) & (card.getValue() == top.getValue() + 1);
+    }
+};
+
+static_assert(sizeof(Card) == 1, "Card must stay one byte");
+static_assert(std::is_trivial<Card>::value && std::is_standard_layout<Card>::value, "Card must stay a POD");
+static_assert(Card(SuitHearts, 1).isRed() == cardSuitIsRed[SuitHearts], "colour bit out of sync with suit table");
+static_assert(Card(SuitClubs, 1).isRed() == cardSuitIsRed[SuitClubs], "colour bit out of sync with suit table");
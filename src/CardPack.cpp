@@ -0,0 +1,62 @@
+#include "CardPack.h"
+#include <fstream>
+#include <vector>
+
+void CardPack::atlasSize(int cellWidth, int cellHeight, uint32_t& width, uint32_t& height) {
+    int rows = (atlasCellCount + atlasColumns - 1) / atlasColumns;
+    width = static_cast<uint32_t>(atlasColumns * (cellWidth + atlasPadding * 2));
+    height = static_cast<uint32_t>(rows * (cellHeight + atlasPadding * 2));
+}
+
+CardPackCell CardPack::layoutCell(int index, int cellWidth, int cellHeight) {
+    CardPackCell cell;
+    cell.x = static_cast<uint16_t>((index % atlasColumns) * (cellWidth + atlasPadding * 2) + atlasPadding);
+    cell.y = static_cast<uint16_t>((index / atlasColumns) * (cellHeight + atlasPadding * 2) + atlasPadding);
+    cell.width = static_cast<uint16_t>(cellWidth);
+    cell.height = static_cast<uint16_t>(cellHeight);
+    return cell;
+}
+
+bool CardPack::parse(const uint8_t* data, size_t size, const CardPackHeader*& header, const CardPackCell*& cells,
+                     const uint8_t*& pixels) {
+    if (!data || size < sizeof(CardPackHeader)) {
+        return false;
+    }
+    header = reinterpret_cast<const CardPackHeader*>(data);
+    if (header->magic != cardPackMagic || header->version != cardPackVersion || header->cellCount != atlasCellCount) {
+        return false;
+    }
+    uint64_t pixelBytes = uint64_t(header->atlasWidth) * header->atlasHeight * 4;
+    size_t cellsEnd = sizeof(CardPackHeader) + sizeof(CardPackCell) * atlasCellCount;
+    if (header->pixelBytes != pixelBytes || header->pixelOffset < cellsEnd ||
+        header->pixelOffset % cardPackAlignment != 0 || header->pixelOffset + pixelBytes > size) {
+        return false;
+    }
+
+    cells = reinterpret_cast<const CardPackCell*>(data + sizeof(CardPackHeader));
+    for (int i = 0; i < atlasCellCount; i++) {
+        if (uint32_t(cells[i].x) + cells[i].width > header->atlasWidth ||
+            uint32_t(cells[i].y) + cells[i].height > header->atlasHeight) {
+            return false;
+        }
+    }
+    pixels = data + header->pixelOffset;
+    return true;
+}
+
+bool CardPack::write(const std::string& path, float scale, uint32_t atlasWidth, uint32_t atlasHeight,
+                     const CardPackCell cells[atlasCellCount], const uint8_t* pixels) {
+    size_t cellsEnd = sizeof(CardPackHeader) + sizeof(CardPackCell) * atlasCellCount;
+    uint32_t pixelOffset = static_cast<uint32_t>((cellsEnd + cardPackAlignment - 1) / cardPackAlignment * cardPackAlignment);
+
+    CardPackHeader header = {cardPackMagic, cardPackVersion, static_cast<uint16_t>(atlasCellCount), atlasWidth,
+                             atlasHeight, pixelOffset, atlasWidth * atlasHeight * 4, scale, 0};
+    std::vector<char> padding(pixelOffset - cellsEnd, 0);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(cells), sizeof(CardPackCell) * atlasCellCount);
+    file.write(padding.data(), padding.size());
+    file.write(reinterpret_cast<const char*>(pixels), header.pixelBytes);
+    return file.good();
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "Card.h"
+
+// Atlas cells: the 52 faces by Card::getIndex(), then the card back
+const int atlasBackCell = cardDeckSize;
+const int atlasCellCount = cardDeckSize + 1;
+const int atlasColumns = 8;
+const int atlasPadding = 2;  // Transparent gutter so filtering never samples a neighbour
+
+// Card pack layout, little endian:
+//   CardPackHeader
+//   CardPackCell[cellCount]
+//   zero padding up to pixelOffset
+//   the atlas as atlasWidth * atlasHeight RGBA8 pixels, top row first
+// The pixels are ready for upload, so loading a pack needs no PNG decoding
+// or resizing and the file can be mapped straight into memory.
+const uint32_t cardPackMagic = 0x4B41504B;  // "KPAK"
+const uint16_t cardPackVersion = 1;
+const uint32_t cardPackAlignment = 64;
+
+struct CardPackHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t cellCount;
+    uint32_t atlasWidth;
+    uint32_t atlasHeight;
+    uint32_t pixelOffset;  // From the start of the file, a multiple of cardPackAlignment
+    uint32_t pixelBytes;   // atlasWidth * atlasHeight * 4
+    float scale;           // Card scale the cells were baked at
+    uint32_t reserved;
+};
+
+// A cell with zero width had no source image
+struct CardPackCell {
+    uint16_t x;
+    uint16_t y;
+    uint16_t width;
+    uint16_t height;
+};
+
+static_assert(sizeof(CardPackHeader) == 32, "CardPackHeader layout changed");
+static_assert(sizeof(CardPackCell) == 8, "CardPackCell layout changed");
+
+// Atlas layout shared by the game and the pack tool
+class CardPack {
+public:
+    static void atlasSize(int cellWidth, int cellHeight, uint32_t& width, uint32_t& height);
+    static CardPackCell layoutCell(int index, int cellWidth, int cellHeight);
+
+    // Checks a pack in memory and points into it. Returns false unless the
+    // header, the cells and the pixel data all fit inside size bytes.
+    static bool parse(const uint8_t* data, size_t size, const CardPackHeader*& header, const CardPackCell*& cells,
+                      const uint8_t*& pixels);
+
+    static bool write(const std::string& path, float scale, uint32_t atlasWidth, uint32_t atlasHeight,
+                      const CardPackCell cells[atlasCellCount], const uint8_t* pixels);
+};
@@ -0,0 +1,69 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include "Card.h"
+
+// A pile of at most a whole deck, stored inline. It has the parts of the
+// std::vector interface the engine uses, but never allocates: a Klondike is
+// one flat block, so copying a game for the solver is a memcpy and no move,
+// deal, recycle or load touches the heap. Going past cardDeckSize cards is a
+// bug in the caller, checked by assert only.
+class CardPile {
+public:
+    typedef Card value_type;
+    typedef Card* iterator;
+    typedef const Card* const_iterator;
+    typedef std::reverse_iterator<const Card*> const_reverse_iterator;
+
+    CardPile() : count(0) {}
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == cardDeckSize; }
+    static constexpr size_t capacity() { return cardDeckSize; }
+
+    Card* data() { return cards; }
+    const Card* data() const { return cards; }
+    iterator begin() { return cards; }
+    iterator end() { return cards + count; }
+    const_iterator begin() const { return cards; }
+    const_iterator end() const { return cards + count; }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    Card& operator[](size_t i) { return cards[i]; }
+    Card operator[](size_t i) const { return cards[i]; }
+    Card& back() { return cards[count - 1]; }
+    Card back() const { return cards[count - 1]; }
+
+    void clear() { count = 0; }
+    void push_back(Card card) {
+        assert(count < cardDeckSize);
+        cards[count++] = card;
+    }
+    void pop_back() { count--; }
+    // Only ever shrinks the pile, the engine never grows one this way
+    void resize(size_t size) {
+        assert(size <= count);
+        count = static_cast<uint8_t>(size);
+    }
+    void assign(const Card* first, const Card* last) {
+        count = 0;
+        append(first, last);
+    }
+    // Adds [first, last) on top; the range must not be part of this pile
+    void append(const Card* first, const Card* last) {
+        size_t n = static_cast<size_t>(last - first);
+        assert(count + n <= cardDeckSize);
+        std::memcpy(cards + count, first, n);
+        count = static_cast<uint8_t>(count + n);
+    }
+
+private:
+    uint8_t count;
+    Card cards[cardDeckSize];
+};
+
+static_assert(sizeof(CardPile) == cardDeckSize + 1, "CardPile layout changed");
@@ -0,0 +1,416 @@
+#include "CardRenderer.h"
+#include "MappedFile.h"
+#include "Solitaire.h"
+#include "Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Initialize static members
+CardAtlas CardRenderer::atlases[atlasCacheSize] = {};
+int CardRenderer::current = -1;
+int CardRenderer::building = -1;
+unsigned int CardRenderer::swapCount = 0;
+float CardRenderer::wantedScale = 0.0f;
+double CardRenderer::wantedSince = 0.0;
+bool CardRenderer::resizePending = false;
+bool CardRenderer::texturesLoaded = false;
+bool CardRenderer::isMobile = false;  // Initialize isMobile to false
+unsigned int CardRenderer::lastTextureId = ~0u;
+CardRenderStats CardRenderer::stats = {0, 0};
+bool CardRenderer::usePack = true;
+bool CardRenderer::packLoaded = false;
+
+extern float gameScale;
+
+// Background loading state. Workers claim cells through nextJob and publish a
+// decoded image by storing CellDecoded with release order; only the main
+// thread touches the atlas texture and the counters below.
+enum CellState { CellPending, CellDecoded, CellMissing, CellUploaded };
+
+static std::string cellPaths[atlasCellCount];
+// The card pack stays mapped once uploaded, later scales are cut and resized
+// from its pixels instead of decoding the PNGs again
+static MappedFile packFile;
+static const CardPackHeader* packHeader = nullptr;
+static const CardPackCell* packCells = nullptr;
+static const uint8_t* packPixels = nullptr;
+static Image decodedImages[atlasCellCount];
+static std::atomic<int> cellStates[atlasCellCount];
+static std::atomic<int> nextJob(0);
+static std::atomic<bool> cancelLoading(false);
+static std::vector<std::thread> decodeWorkers;
+static int decodeWidth = 0;
+static int decodeHeight = 0;
+static int completedCells = 0;
+static std::chrono::steady_clock::time_point loadingStart;
+
+// Window scales are rounded up to a multiple of scaleBucketStep, so an atlas
+// is only ever shrunk on screen
+const float scaleBucketStep = 0.5f;
+const float minBucketScale = 1.0f;
+const float maxBucketScale = 4.0f;
+// How long the window scale must stay in a new bucket before rebuilding
+const double resizeSettleSeconds = 0.3;
+
+// The back is decoded first, it is on screen from the first frame
+static int cellForJob(int job) {
+    return job == 0 ? atlasBackCell : job - 1;
+}
+
+static Image loadCellImage(int cell) {
+    if (!packPixels) {
+        return LoadImage(cellPaths[cell].c_str());
+    }
+    const CardPackCell& source = packCells[cell];
+    if (source.width == 0) {
+        return Image{};
+    }
+    Image atlasImage = { const_cast<uint8_t*>(packPixels), static_cast<int>(packHeader->atlasWidth),
+                         static_cast<int>(packHeader->atlasHeight), 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+    Rectangle rect = { static_cast<float>(source.x), static_cast<float>(source.y), static_cast<float>(source.width),
+                       static_cast<float>(source.height) };
+    return ImageFromImage(atlasImage, rect);
+}
+
+static void decodeCell(int cell) {
+    TRACE_SCOPE("decode cell");
+    Image img = loadCellImage(cell);
+    if (img.data == NULL) {
+        cellStates[cell].store(CellMissing, std::memory_order_release);
+        return;
+    }
+    ImageResize(&img, decodeWidth, decodeHeight);
+    ImageFormat(&img, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    decodedImages[cell] = img;
+    cellStates[cell].store(CellDecoded, std::memory_order_release);
+}
+
+static void decodeWorker() {
+    Trace::setThreadName("card decode");
+    while (!cancelLoading.load(std::memory_order_relaxed)) {
+        int job = nextJob.fetch_add(1, std::memory_order_relaxed);
+        if (job >= atlasCellCount) {
+            break;
+        }
+        decodeCell(cellForJob(job));
+    }
+}
+
+static std::string assetPath(const std::string& fileName) {
+    std::string imagePath = "assets/" + fileName;
+    if (!FileExists(imagePath.c_str())) {
+        // Try alternative path
+        imagePath = std::string(GetWorkingDirectory()) + "/assets/" + fileName;
+    }
+    return imagePath;
+}
+
+std::string CardRenderer::getImagePath(Card card) {
+    return assetPath("cards/" + std::string(card.getValueName()) + "_of_" + card.getSuitName() + ".png");
+}
+
+std::string CardRenderer::getCardBackPath() {
+    return assetPath("cards/card_back_red.png");
+}
+
+std::string CardRenderer::getPackPath() {
+    return assetPath("cards.pack");
+}
+
+std::string CardRenderer::getAssetPath(const std::string& fileName) {
+    return assetPath(fileName);
+}
+
+void CardRenderer::loadAtlas() {
+    TRACE_SCOPE("loadAtlas");
+    unloadAllTextures();
+    if (usePack && loadPack(getPackPath())) {
+        return;
+    }
+    preloadTextures();
+}
+
+bool CardRenderer::loadPack(const std::string& packPath) {
+    TRACE_SCOPE("loadPack");
+    const CardPackHeader* header;
+    const CardPackCell* cells;
+    const uint8_t* pixels;
+    if (!packFile.open(packPath) || !CardPack::parse(packFile.data(), packFile.size(), header, cells, pixels)) {
+        packFile.close();
+        return false;
+    }
+
+    // The pixels go to the GPU straight from the mapped file
+    Image image = { const_cast<uint8_t*>(pixels), static_cast<int>(header->atlasWidth), static_cast<int>(header->atlasHeight),
+                    1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+    int slot = evictAtlas();
+    CardAtlas& atlas = atlases[slot];
+    atlas.texture = LoadTextureFromImage(image);
+    if (atlas.texture.id == 0) {
+        packFile.close();
+        return false;
+    }
+    SetTextureFilter(atlas.texture, TEXTURE_FILTER_BILINEAR);
+    packHeader = header;
+    packCells = cells;
+    packPixels = pixels;
+
+    for (int i = 0; i < atlasCellCount; i++) {
+        const CardPackCell& cell = packCells[i];
+        atlas.cells[i] = { static_cast<float>(cell.x), static_cast<float>(cell.y), static_cast<float>(cell.width), static_cast<float>(cell.height) };
+        atlas.cellLoaded[i] = cell.width > 0;
+    }
+    atlas.scale = header->scale;
+    atlas.lastUsed = ++swapCount;
+    current = slot;
+    texturesLoaded = true;
+    packLoaded = true;
+    return true;
+}
+
+float CardRenderer::bucketScale(float scale) {
+    // The small tolerance keeps float noise on an exact step in that bucket
+    float bucket = std::ceil(scale / scaleBucketStep - 0.01f) * scaleBucketStep;
+    return std::min(maxBucketScale, std::max(minBucketScale, bucket));
+}
+
+float CardRenderer::getAtlasScale() {
+    if (current >= 0) return atlases[current].scale;
+    if (building >= 0) return atlases[building].scale;
+    return 1.0f;
+}
+
+void CardRenderer::preloadTextures() {
+    if (texturesLoaded || building >= 0) {
+        return;
+    }
+    startBuild(bucketScale(gameScale));
+}
+
+void CardRenderer::requestScale(float scale) {
+    float bucket = bucketScale(scale);
+    if ((current >= 0 && atlases[current].scale == bucket) || (building >= 0 && atlases[building].scale == bucket)) {
+        return;
+    }
+    for (int i = 0; i < atlasCacheSize; i++) {
+        if (i != current && i != building && atlases[i].texture.id != 0 && atlases[i].scale == bucket) {
+            cancelBuild();
+            atlases[i].lastUsed = ++swapCount;
+            current = i;
+            return;
+        }
+    }
+    startBuild(bucket);
+}
+
+int CardRenderer::evictAtlas() {
+    // An empty slot if there is one, otherwise the least recently used
+    int slot = -1;
+    for (int i = 0; i < atlasCacheSize; i++) {
+        if (i == current || i == building) {
+            continue;
+        }
+        if (atlases[i].texture.id == 0) {
+            return i;
+        }
+        if (slot < 0 || atlases[i].lastUsed < atlases[slot].lastUsed) {
+            slot = i;
+        }
+    }
+    UnloadTexture(atlases[slot].texture);
+    atlases[slot] = CardAtlas();
+    return slot;
+}
+
+void CardRenderer::startBuild(float scale) {
+    TRACE_SCOPE("startBuild");
+    cancelBuild();
+
+    // Bake the cells at the bucket scale, the game renders at that scale too
+    decodeWidth = static_cast<int>(baseCardWidth * scale);
+    decodeHeight = static_cast<int>(baseCardHeight * scale);
+    uint32_t atlasWidth, atlasHeight;
+    CardPack::atlasSize(decodeWidth, decodeHeight, atlasWidth, atlasHeight);
+    int slot = evictAtlas();
+    CardAtlas& atlas = atlases[slot];
+    Image blank = GenImageColor(atlasWidth, atlasHeight, BLANK);
+    atlas.texture = LoadTextureFromImage(blank);
+    UnloadImage(blank);
+    if (atlas.texture.id == 0) {
+        return;
+    }
+    SetTextureFilter(atlas.texture, TEXTURE_FILTER_BILINEAR);
+    atlas.scale = scale;
+
+    // Paths are resolved here, FileExists and GetWorkingDirectory are not
+    // safe to call from the workers. With a pack mapped they are not needed.
+    for (int i = 0; i < atlasCellCount; i++) {
+        CardPackCell cell = CardPack::layoutCell(i, decodeWidth, decodeHeight);
+        atlas.cells[i] = { static_cast<float>(cell.x), static_cast<float>(cell.y), static_cast<float>(cell.width), static_cast<float>(cell.height) };
+        atlas.cellLoaded[i] = false;
+        if (!packPixels) {
+            cellPaths[i] = i == atlasBackCell ? getCardBackPath() : getImagePath(Card::fromIndex(i));
+            if (!FileExists(cellPaths[i].c_str())) {
+                std::cerr << "Could not find card image: " << cellPaths[i] << std::endl;
+            }
+        }
+        cellStates[i].store(CellPending, std::memory_order_relaxed);
+    }
+    nextJob = 0;
+    cancelLoading = false;
+    completedCells = 0;
+    building = slot;
+    loadingStart = std::chrono::steady_clock::now();
+
+#ifndef __EMSCRIPTEN__
+    // Web builds have no threads, update() decodes there instead
+    unsigned workerCount = std::max(1u, std::min<unsigned>(std::thread::hardware_concurrency(), atlasCellCount));
+    for (unsigned i = 0; i < workerCount; i++) {
+        decodeWorkers.emplace_back(decodeWorker);
+    }
+#endif
+}
+
+void CardRenderer::cancelBuild() {
+    // Stop the workers first, they may still be writing images
+    cancelLoading = true;
+    for (auto& worker : decodeWorkers) {
+        worker.join();
+    }
+    decodeWorkers.clear();
+    for (int i = 0; i < atlasCellCount; i++) {
+        if (cellStates[i].load(std::memory_order_acquire) == CellDecoded) {
+            UnloadImage(decodedImages[i]);
+            decodedImages[i] = Image{};
+        }
+        cellStates[i].store(CellPending, std::memory_order_relaxed);
+    }
+    if (building >= 0) {
+        UnloadTexture(atlases[building].texture);
+        atlases[building] = CardAtlas();
+        building = -1;
+    }
+}
+
+void CardRenderer::uploadCell(int cell) {
+    TRACE_SCOPE("upload cell");
+    CardAtlas& atlas = atlases[building];
+    if (cellStates[cell].load(std::memory_order_acquire) == CellDecoded) {
+        UpdateTextureRec(atlas.texture, atlas.cells[cell], decodedImages[cell].data);
+        UnloadImage(decodedImages[cell]);
+        decodedImages[cell] = Image{};
+        atlas.cellLoaded[cell] = true;
+    }
+    cellStates[cell].store(CellUploaded, std::memory_order_relaxed);
+    completedCells++;
+}
+
+void CardRenderer::update(double budgetSeconds) {
+    // Rebuild for the window scale once it has stayed in a new bucket for a
+    // moment, so dragging the window edge does not start a build per frame
+    float bucket = bucketScale(gameScale);
+    double now = GetTime();
+    if (bucket != wantedScale) {
+        wantedScale = bucket;
+        wantedSince = now;
+        resizePending = true;
+    } else if (resizePending && current >= 0 && now - wantedSince >= resizeSettleSeconds) {
+        resizePending = false;
+        requestScale(bucket);
+    }
+
+    if (building < 0) {
+        return;
+    }
+
+    // At least one cell goes up every frame, however small the budget
+    auto start = std::chrono::steady_clock::now();
+    for (int job = 0; job < atlasCellCount; job++) {
+        int cell = cellForJob(job);
+        int state = cellStates[cell].load(std::memory_order_acquire);
+        if (state == CellPending && decodeWorkers.empty()) {
+            decodeCell(cell);
+            state = cellStates[cell].load(std::memory_order_relaxed);
+        }
+        if (state != CellDecoded && state != CellMissing) {
+            continue;
+        }
+        uploadCell(cell);
+        if (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() >= budgetSeconds) {
+            break;
+        }
+    }
+
+    if (completedCells == atlasCellCount) {
+        for (auto& worker : decodeWorkers) {
+            worker.join();
+        }
+        decodeWorkers.clear();
+        // The finished atlas replaces the old one between two frames, the
+        // board never shows a partly filled atlas once one is complete
+        current = building;
+        building = -1;
+        atlases[current].lastUsed = ++swapCount;
+        texturesLoaded = true;
+        Trace::instant("atlas ready");
+        double millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadingStart).count();
+        TraceLog(LOG_INFO, "Card atlas for scale %.1f built in %.1f ms", atlases[current].scale, millis);
+    }
+}
+
+float CardRenderer::getLoadingProgress() {
+    if (building < 0) return 1.0f;
+    return static_cast<float>(completedCells) / atlasCellCount;
+}
+
+void CardRenderer::unloadAllTextures() {
+    cancelBuild();
+    for (int i = 0; i < atlasCacheSize; i++) {
+        if (atlases[i].texture.id != 0) {
+            UnloadTexture(atlases[i].texture);
+        }
+        atlases[i] = CardAtlas();
+    }
+    current = -1;
+    texturesLoaded = false;
+    packLoaded = false;
+    packHeader = nullptr;
+    packCells = nullptr;
+    packPixels = nullptr;
+    packFile.close();
+}
+
+void CardRenderer::beginFrame() {
+    stats = {0, 0};
+    lastTextureId = ~0u;  // The first card always starts a batch
+}
+
+void CardRenderer::countDraw(unsigned int textureId) {
+    stats.cardsDrawn++;
+    if (textureId != lastTextureId) {
+        stats.textureSwitches++;
+        lastTextureId = textureId;
+    }
+}
+
+void CardRenderer::draw(Card card, float x, float y) {
+    // Until the first atlas is complete its cells show up as they arrive
+    const CardAtlas* atlas = current >= 0 ? &atlases[current] : building >= 0 ? &atlases[building] : nullptr;
+    int cell = card.isFaceUp() ? card.getIndex() : atlasBackCell;
+    if (atlas && atlas->cellLoaded[cell]) {
+        Rectangle dest = { x, y, static_cast<float>(baseCardWidth), static_cast<float>(baseCardHeight) };
+        DrawTexturePro(atlas->texture, atlas->cells[cell], dest, { 0, 0 }, 0.0f, WHITE);
+        countDraw(atlas->texture.id);
+        return;
+    }
+
+    // Fallback if the image failed to load, drawn with the shapes texture
+    DrawRectangle((int)x, (int)y, baseCardWidth, baseCardHeight, card.isFaceUp() ? BLUE : RED);
+    DrawRectangleLines((int)x, (int)y, baseCardWidth, baseCardHeight, BLACK);
+    countDraw(0);
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <raylib.h>
+#include <string>
+#include "Card.h"
+#include "CardPack.h"
+
+// Card drawing counters for the current frame, reset by beginFrame()
+struct CardRenderStats {
+    int cardsDrawn;       // Card quads submitted
+    int textureSwitches;  // Card draws whose texture differs from the previous card's, each ends a batch
+};
+
+// One baked copy of the card atlas
+struct CardAtlas {
+    Texture2D texture;
+    Rectangle cells[atlasCellCount];  // Source rectangles in the atlas
+    bool cellLoaded[atlasCellCount];  // False where the image was missing
+    float scale;                      // Card scale the cells were baked at
+    unsigned int lastUsed;            // Swap count when last made current
+};
+
+// Owns the card textures and draws cards. Every face and the back live in one
+// atlas texture, so consecutive cards never switch textures and raylib can
+// send a whole board in a single batch.
+//
+// Atlases are baked per scale bucket. After the window scale has settled on a
+// new bucket the next one is built in the background while the old one keeps
+// drawing, then swapped in between frames. The last few buckets stay cached,
+// so going back and forth between window sizes does not rebuild every time.
+class CardRenderer {
+private:
+    static const int atlasCacheSize = 3;
+    static CardAtlas atlases[atlasCacheSize];
+    static int current;   // Atlas being drawn, -1 until one is complete
+    static int building;  // Atlas being filled by the workers, -1 when idle
+    static unsigned int swapCount;
+    static float wantedScale;    // Bucket of the window scale
+    static double wantedSince;   // Time the window scale entered that bucket
+    static bool resizePending;   // Bucket changed and not requested yet
+    static bool texturesLoaded;  // Flag to track if textures are pre-loaded
+    static unsigned int lastTextureId;
+    static CardRenderStats stats;
+    static bool usePack;
+    static bool packLoaded;
+
+    static void countDraw(unsigned int textureId);
+    static bool loadPack(const std::string& packPath);
+    static void startBuild(float scale);
+    static void cancelBuild();
+    static int evictAtlas();
+    static void uploadCell(int cell);
+
+public:
+    static bool isMobile;  // Flag to track if running on mobile device
+
+    static std::string getImagePath(Card card);
+    static std::string getCardBackPath();
+    static std::string getPackPath();
+    static std::string getAssetPath(const std::string& fileName);
+    static void draw(Card card, float x, float y);
+
+    // Uploads the precooked card pack written by pack-cards as the atlas, or
+    // starts decoding the 53 card images into one when there is no usable pack.
+    // The pack stays mapped, atlases for other scales are resized from it.
+    static void loadAtlas();
+    static void setUsePack(bool value) { usePack = value; }
+    static bool isPackLoaded() { return packLoaded; }
+    static void unloadAllTextures();
+    // Decodes and scales the card images, or cuts them from the mapped pack,
+    // on a worker pool sized to the core count, for the current window scale.
+    // The GPU upload happens in update(), on the main thread.
+    static void preloadTextures();
+    // Uploads decoded cells into the atlas being built until budgetSeconds
+    // have passed and starts a rebuild once a resize has settled. Call once
+    // per frame.
+    static void update(double budgetSeconds = 0.004);
+    // Makes the atlas for scale's bucket current, at once if it is cached and
+    // otherwise after it has been built in the background
+    static void requestScale(float scale);
+    // Rounds a window scale up to the scale its atlas is baked at
+    static float bucketScale(float scale);
+    // Scale of the atlas being drawn. A render target of the base size times
+    // this maps atlas texels 1:1.
+    static float getAtlasScale();
+    static bool areTexturesLoaded() { return texturesLoaded; }  // Check if textures are loaded
+    // True while an atlas is being built or a resize is waiting to settle,
+    // update() has work to do on the coming frames
+    static bool isBusy() { return building >= 0 || resizePending; }
+    static float getLoadingProgress();  // Fraction of the cells uploaded, 1 when idle
+    static void setIsMobile(int value) { isMobile = value != 0; }
+
+    static void beginFrame();
+    static const CardRenderStats& getStats() { return stats; }
+};
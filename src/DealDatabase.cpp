@@ -0,0 +1,131 @@
+#include "DealDatabase.h"
+#include "BatchAnalyzer.h"
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+size_t wordCount(uint32_t seedCount) { return (size_t(seedCount) + 63) / 64; }
+
+int popCount(uint64_t x) {
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return static_cast<int>((x * 0x0101010101010101ull) >> 56);
+}
+
+} // namespace
+
+DealDatabase::DealDatabase() : header(nullptr), bitmap(nullptr), rank(nullptr), records(nullptr) {}
+
+bool DealDatabase::open(const std::string& path) {
+    close();
+    if (!file.open(path) || !parse(file.data(), file.size(), header, bitmap, rank, records)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void DealDatabase::close() {
+    file.close();
+    header = nullptr;
+    bitmap = nullptr;
+    rank = nullptr;
+    records = nullptr;
+}
+
+const DealDatabaseHeader& DealDatabase::getHeader() const {
+    static const DealDatabaseHeader empty = {};
+    return header ? *header : empty;
+}
+
+bool DealDatabase::parse(const uint8_t* data, size_t size, const DealDatabaseHeader*& header, const uint64_t*& bitmap,
+                         const uint32_t*& rank, const DealDatabaseRecord*& records) {
+    if (!data || size < sizeof(DealDatabaseHeader)) {
+        return false;
+    }
+    header = reinterpret_cast<const DealDatabaseHeader*>(data);
+    if (header->magic != dealDatabaseMagic || header->version != dealDatabaseVersion ||
+        header->dealCount > header->seedCount) {
+        return false;
+    }
+    size_t words = wordCount(header->seedCount);
+    size_t rankOffset = sizeof(DealDatabaseHeader) + words * sizeof(uint64_t);
+    size_t recordOffset = rankOffset + words * sizeof(uint32_t);
+    if (recordOffset + size_t(header->dealCount) * sizeof(DealDatabaseRecord) != size) {
+        return false;
+    }
+    bitmap = reinterpret_cast<const uint64_t*>(data + sizeof(DealDatabaseHeader));
+    rank = reinterpret_cast<const uint32_t*>(data + rankOffset);
+    records = reinterpret_cast<const DealDatabaseRecord*>(data + recordOffset);
+
+    // The last rank entry is enough to catch a truncated or mixed up table
+    // without reading the whole file
+    return words == 0 ? header->dealCount == 0
+                      : rank[words - 1] + popCount(bitmap[words - 1]) == header->dealCount;
+}
+
+const DealDatabaseRecord* DealDatabase::find(uint32_t seed) const {
+    if (!header) {
+        return nullptr;
+    }
+    uint32_t offset = seed - header->firstSeed;
+    if (offset >= header->seedCount) {
+        return nullptr;
+    }
+    uint64_t word = bitmap[offset / 64];
+    uint64_t bit = uint64_t(1) << (offset % 64);
+    if (!(word & bit)) {
+        return nullptr;
+    }
+    uint32_t index = rank[offset / 64] + popCount(word & (bit - 1));
+    return index < header->dealCount ? &records[index] : nullptr;
+}
+
+bool DealDatabase::pick(Xoshiro256& rng, uint32_t& seed) const {
+    if (size() == 0) {
+        return false;
+    }
+    seed = records[rng.below(size())].seed;
+    return true;
+}
+
+bool DealDatabase::build(const std::string& resultsPath, const std::string& outputPath, DealDatabaseHeader& header) {
+    AnalyzerFileHeader results;
+    if (!BatchAnalyzer::readHeader(resultsPath, results)) {
+        return false;
+    }
+    std::ifstream input(resultsPath, std::ios::binary);
+    input.seekg(sizeof(results));
+
+    size_t words = wordCount(results.count);
+    std::vector<uint64_t> bitmap(words, 0);
+    std::vector<uint32_t> rank(words, 0);
+    std::vector<DealDatabaseRecord> records;
+    AnalyzerRecord record;
+    for (uint32_t i = 0; i < results.count && input.read(reinterpret_cast<char*>(&record), sizeof(record)); i++) {
+        // Unfinished records of an interrupted run are zero and skipped
+        if (!(record.flags & AnalyzerRecord::presentFlag) || record.status != SolverSolved ||
+            record.seed != results.firstSeed + i) {
+            continue;
+        }
+        bitmap[i / 64] |= uint64_t(1) << (i % 64);
+        records.push_back({record.seed, record.solutionLength, 0});
+    }
+    uint32_t total = 0;
+    for (size_t w = 0; w < words; w++) {
+        rank[w] = total;
+        total += popCount(bitmap[w]);
+    }
+
+    header = {dealDatabaseMagic, dealDatabaseVersion, results.drawCount, 0, results.firstSeed,
+              results.count, static_cast<uint32_t>(records.size()), 0, results.nodeBudget};
+    std::ofstream file(outputPath, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(bitmap.data()), words * sizeof(uint64_t));
+    file.write(reinterpret_cast<const char*>(rank.data()), words * sizeof(uint32_t));
+    file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(DealDatabaseRecord));
+    return file.good();
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "MappedFile.h"
+#include "Random.h"
+
+// Winnable deal database layout, little endian:
+//   DealDatabaseHeader
+//   uint64_t bitmap[wordCount]  bit i of word w is set when seed
+//                               firstSeed + w * 64 + i was solved
+//   uint32_t rank[wordCount]    set bits in the words before word w
+//   DealDatabaseRecord[dealCount], the solved seeds in increasing order
+// where wordCount = (seedCount + 63) / 64. The bitmap and the rank table
+// answer "is this seed winnable" and find its record in constant time, and a
+// random record is a random index, so nothing is ever scanned or loaded.
+const uint32_t dealDatabaseMagic = 0x4244574B;  // "KWDB"
+const uint16_t dealDatabaseVersion = 1;
+
+struct DealDatabaseHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t drawCount;   // Cards per stock turn the seeds were solved with
+    uint8_t reserved;
+    uint32_t firstSeed;
+    uint32_t seedCount;  // Seeds the bitmap covers, solved or not
+    uint32_t dealCount;  // Solved seeds, one record each
+    uint32_t reserved2;
+    uint64_t nodeBudget; // Solver budget per seed, seeds over it count as not solved
+};
+
+struct DealDatabaseRecord {
+    uint32_t seed;
+    uint16_t solutionLength;  // Moves in the solver's solution, saturated
+    uint16_t reserved;
+};
+
+static_assert(sizeof(DealDatabaseHeader) == 32, "DealDatabaseHeader layout changed");
+static_assert(sizeof(DealDatabaseRecord) == 8, "DealDatabaseRecord layout changed");
+
+// A winnable deal database mapped read-only. Pages are only read when a
+// lookup touches them.
+class DealDatabase {
+public:
+    DealDatabase();
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    // Zeroed when no database is open
+    const DealDatabaseHeader& getHeader() const;
+    uint32_t size() const { return header ? header->dealCount : 0; }
+    const DealDatabaseRecord& record(uint32_t index) const { return records[index]; }
+
+    // Returns the record of seed, or nullptr if the seed was not solved or
+    // is outside the range the database covers
+    const DealDatabaseRecord* find(uint32_t seed) const;
+    // Sets seed to a winnable seed picked uniformly, returns false if there is none
+    bool pick(Xoshiro256& rng, uint32_t& seed) const;
+
+    // Checks a database in memory and points into it. Returns false unless
+    // every section fits inside size bytes.
+    static bool parse(const uint8_t* data, size_t size, const DealDatabaseHeader*& header, const uint64_t*& bitmap,
+                      const uint32_t*& rank, const DealDatabaseRecord*& records);
+
+    // Writes a database with every solved seed of a klondike-analyze results
+    // file. header receives the header written.
+    static bool build(const std::string& resultsPath, const std::string& outputPath, DealDatabaseHeader& header);
+
+private:
+    MappedFile file;
+    const DealDatabaseHeader* header;
+    const uint64_t* bitmap;
+    const uint32_t* rank;
+    const DealDatabaseRecord* records;
+};
@@ -0,0 +1,96 @@
+#include "FrameProfiler.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+namespace {
+
+const char* phaseNames[] = {"update", "draw", "target", "blit", "present", "total"};
+
+float millisSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+FrameProfiler::FrameProfiler(size_t capacity)
+    : ring(std::max<size_t>(capacity, 1)), head(0), count(0), frameNumber(0), currentFrame() {
+    scratch.reserve(ring.size());
+}
+
+const char* FrameProfiler::phaseName(int phase) {
+    return phase >= 0 && phase <= FramePhaseCount ? phaseNames[phase] : "";
+}
+
+void FrameProfiler::beginFrame() {
+    currentFrame = FrameTiming();
+    currentFrame.frame = frameNumber;
+    frameStart = Clock::now();
+}
+
+void FrameProfiler::begin(FramePhase phase) {
+    phaseStart[phase] = Clock::now();
+}
+
+void FrameProfiler::end(FramePhase phase) {
+    currentFrame.phases[phase] += millisSince(phaseStart[phase]);
+}
+
+void FrameProfiler::endFrame() {
+    currentFrame.total = millisSince(frameStart);
+    ring[head] = currentFrame;
+    head = (head + 1) % ring.size();
+    count = std::min(count + 1, ring.size());
+    frameNumber++;
+}
+
+const FrameTiming& FrameProfiler::frame(size_t i) const {
+    return ring[(head + ring.size() - count + i) % ring.size()];
+}
+
+FramePhaseStats FrameProfiler::stats(int phase) const {
+    FramePhaseStats result = {0, 0, 0, 0};
+    if (count == 0) {
+        return result;
+    }
+    scratch.clear();
+    for (size_t i = 0; i < count; i++) {
+        const FrameTiming& timing = frame(i);
+        scratch.push_back(phase == FramePhaseCount ? timing.total : timing.phases[phase]);
+    }
+    // Nearest rank, the ceil(p * n)-th smallest; one sort is cheaper than four
+    // selections at these sizes. The epsilon keeps an exact product like
+    // 0.95 * 600 from rounding up a rank.
+    std::sort(scratch.begin(), scratch.end());
+    auto rank = [&](double percentile) {
+        size_t index = static_cast<size_t>(std::ceil(percentile * count - 1e-9));
+        return scratch[std::min(count - 1, index > 0 ? index - 1 : 0)];
+    };
+    result.p50 = rank(0.50);
+    result.p95 = rank(0.95);
+    result.p99 = rank(0.99);
+    result.max = scratch.back();
+    return result;
+}
+
+bool FrameProfiler::writeCsv(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    file << "frame";
+    for (int phase = 0; phase <= FramePhaseCount; phase++) {
+        file << ',' << phaseNames[phase] << "_ms";
+    }
+    file << '\n' << std::fixed << std::setprecision(4);
+    for (size_t i = 0; i < count; i++) {
+        const FrameTiming& timing = frame(i);
+        file << timing.frame;
+        for (int phase = 0; phase < FramePhaseCount; phase++) {
+            file << ',' << timing.phases[phase];
+        }
+        file << ',' << timing.total << '\n';
+    }
+    return file.good();
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Parts of a frame of the main loop
+enum FramePhase {
+    FramePhaseUpdate,   // game->update()
+    FramePhaseDraw,     // game->draw()
+    FramePhaseTarget,   // Begin/EndTextureMode and the camera around the draw
+    FramePhaseBlit,     // Scaled copy of the game target to the screen
+    FramePhasePresent,  // EndDrawing(): batch flush, buffer swap and input polling
+    FramePhaseCount
+};
+
+struct FrameTiming {
+    uint64_t frame;                     // Frame number since the profiler started
+    float phases[FramePhaseCount];      // Milliseconds per phase
+    float total;                        // Milliseconds from beginFrame() to endFrame()
+};
+
+struct FramePhaseStats {
+    float p50;
+    float p95;
+    float p99;
+    float max;
+};
+
+// Times the phases of each frame and keeps the last `capacity` frames in a
+// ring buffer. A phase may be entered several times per frame, its times add
+// up. Times are wall clock from steady_clock, not CPU time. Nothing is
+// allocated after construction, so profiling does not disturb the frames it
+// measures.
+class FrameProfiler {
+public:
+    static const size_t defaultCapacity = 600;  // Ten seconds at 60 FPS
+
+    explicit FrameProfiler(size_t capacity = defaultCapacity);
+
+    void beginFrame();
+    void begin(FramePhase phase);
+    void end(FramePhase phase);
+    void endFrame();
+
+    size_t size() const { return count; }
+    size_t capacity() const { return ring.size(); }
+    // Recorded frame i, 0 being the oldest still kept
+    const FrameTiming& frame(size_t i) const;
+
+    // Percentiles over the kept frames, phase FramePhaseCount is the total
+    FramePhaseStats stats(int phase) const;
+    // One line per kept frame, oldest first. Returns false if the file could
+    // not be written.
+    bool writeCsv(const std::string& path) const;
+
+    static const char* phaseName(int phase);  // FramePhaseCount gives "total"
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    std::vector<FrameTiming> ring;
+    size_t head;   // Slot the next frame goes to
+    size_t count;
+    uint64_t frameNumber;
+    FrameTiming currentFrame;
+    Clock::time_point frameStart;
+    Clock::time_point phaseStart[FramePhaseCount];
+    mutable std::vector<float> scratch;  // Sorted copies for stats()
+};
@@ -0,0 +1,224 @@
+#include "HintEngine.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+const uint64_t firstNodeBudget = 20000;
+const uint64_t maxNodeBudget = 64000000;
+const int hintTableBits = 20;
+const int webTableBits = 16;  // Web builds solve in place, once per hint
+
+SolverOptions hintSolverOptions(const std::atomic<bool>* cancel, int tableBits) {
+    SolverOptions options;
+    options.nodeBudget = firstNodeBudget;
+    options.tableBits = tableBits;
+    options.cancel = cancel;
+    return options;
+}
+
+} // namespace
+
+HintEngine::HintEngine(double timeBudgetSeconds)
+    : timeBudgetSeconds(timeBudgetSeconds), stateVersion(0), requested(0), taken(0),
+      pending(false), running(false), quitting(false), revisions(0), cancelFlag(false) {
+#ifndef __EMSCRIPTEN__
+    worker = std::thread(&HintEngine::run, this);
+#endif
+}
+
+HintEngine::~HintEngine() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quitting = true;
+        cancelFlag = true;
+    }
+    wake.notify_one();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void HintEngine::start(const Klondike& game) {
+    stateVersion = game.getStateVersion();
+#ifdef __EMSCRIPTEN__
+    uint64_t job;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = taken = ++requested;
+        resetHint();
+    }
+    Solver solver(hintSolverOptions(nullptr, webTableBits));
+    search(game, job, solver);
+#else
+    {
+        // The flag is raised under the lock, so the worker cannot clear it
+        // for an older job after this one was posted
+        std::lock_guard<std::mutex> lock(mutex);
+        snapshot = game;
+        requested++;
+        pending = true;
+        cancelFlag = true;
+        resetHint();
+    }
+    wake.notify_one();
+#endif
+}
+
+void HintEngine::cancel() {
+    std::lock_guard<std::mutex> lock(mutex);
+    requested++;
+    pending = false;
+    cancelFlag = true;
+    resetHint();
+}
+
+void HintEngine::resetHint() {
+    hint = Hint();
+    hint.revision = ++revisions;
+}
+
+Hint HintEngine::best() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hint;
+}
+
+bool HintEngine::isSearching() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending || (running && taken == requested);
+}
+
+bool HintEngine::publish(uint64_t job, const Hint& result) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (job != requested) {
+        return false;
+    }
+    hint = result;
+    hint.revision = ++revisions;
+    return true;
+}
+
+void HintEngine::run() {
+    // One solver for every job, its transposition table is reused
+    Solver solver(hintSolverOptions(&cancelFlag, hintTableBits));
+    Klondike game;
+    while (true) {
+        uint64_t job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            running = false;
+            wake.wait(lock, [&] { return quitting || pending; });
+            if (quitting) {
+                return;
+            }
+            game = snapshot;
+            job = taken = requested;
+            pending = false;
+            running = true;
+            cancelFlag = false;
+        }
+        search(game, job, solver);
+    }
+}
+
+void HintEngine::search(const Klondike& game, uint64_t job, Solver& solver) {
+    auto start = std::chrono::steady_clock::now();
+    Hint result;
+    result.valid = ruleOfThumb(game, result.move);
+    if (!publish(job, result)) {
+        return;
+    }
+
+    // Iterative widening: each round repeats the last one's work, which
+    // costs at most a third more than searching with the final budget
+    // directly, and a winning line found early is shown early
+    uint64_t budget = firstNodeBudget;
+    while (true) {
+        solver.setNodeBudget(budget);
+        SolverResult solved = solver.solve(game);
+        result.nodes += solved.nodes;
+        if (cancelFlag.load(std::memory_order_relaxed)) {
+            return;
+        }
+        if (solved.status == SolverSolved) {
+            result.valid = !solved.moves.empty();
+            result.winning = result.valid;
+            if (result.valid) {
+                result.move = solved.moves[0];
+            }
+            result.finished = true;
+        } else if (solved.status == SolverUnsolvable || solved.nodes == 0) {
+            // Proven lost, or a position the solver does not take: the rule
+            // of thumb is all there is
+            result.finished = true;
+        } else {
+            // Size the next round so it ends about when the time budget does
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            double remaining = timeBudgetSeconds - elapsed;
+            uint64_t next = std::min(budget * 4, maxNodeBudget);
+            if (solved.nodesPerSecond() > 0) {
+                next = std::min(next, static_cast<uint64_t>(remaining * solved.nodesPerSecond()));
+            }
+            result.finished = remaining <= 0 || next <= budget;
+#ifdef __EMSCRIPTEN__
+            result.finished = true;  // The UI thread is waiting, one round only
+#endif
+            budget = next;
+        }
+        if (!publish(job, result) || result.finished) {
+            return;
+        }
+    }
+}
+
+bool HintEngine::ruleOfThumb(const Klondike& game, Move& move) {
+    int bestScore = 0;
+    for (int source = 0; source < PileCount; source++) {
+        if (!isTableauPile(source) && source != PileWaste) {
+            continue;
+        }
+        const CardPile& pile = game.pile(source);
+        int size = static_cast<int>(pile.size());
+        int first = source == PileWaste ? size - 1 : 0;
+        for (int start = std::max(first, 0); start < size; start++) {
+            if (!pile[start].isFaceUp()) {
+                continue;
+            }
+            bool reveals = isTableauPile(source) && start > 0 && !pile[start - 1].isFaceUp();
+            bool empties = isTableauPile(source) && start == 0;
+            for (int target = 0; target < PileStock; target++) {
+                if (!game.canMove(source, start, target)) {
+                    continue;
+                }
+                int score;
+                if (isFoundationPile(target)) {
+                    score = reveals ? 6 : 5;
+                } else if (reveals) {
+                    score = 4;
+                } else if (empties && !game.pile(target).empty()) {
+                    score = 3;  // Frees a column for a king
+                } else if (source == PileWaste) {
+                    score = 2;
+                } else {
+                    continue;  // Shuffles a run between columns for nothing
+                }
+                if (score > bestScore) {
+                    bestScore = score;
+                    move = Move::cards(source, start, target);
+                }
+            }
+        }
+    }
+    if (bestScore > 0) {
+        return true;
+    }
+    if (!game.stock().empty()) {
+        move = Move::draw();
+        return true;
+    }
+    if (!game.waste().empty()) {
+        move = Move::recycle();
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "Klondike.h"
+#include "Solver.h"
+
+// Best move the hint search has found for one position
+struct Hint {
+    bool valid = false;     // There is a move to suggest
+    bool winning = false;   // move starts a line the solver proved wins
+    bool finished = false;  // The search is over: solved, proven lost or out of time
+    Move move = Move::draw();
+    uint64_t nodes = 0;     // Solver nodes searched so far
+    uint32_t revision = 0;  // Changes whenever the engine's hint changes
+};
+
+// Anytime hint search on a background thread.
+//
+// start() hands a copy of the game to a worker that lives as long as the
+// engine. The worker first publishes a quick rule-of-thumb move, then runs
+// the solver with a node budget that grows four times per round until it
+// finds a winning line, proves there is none or the time budget runs out.
+// cancel() and start() only raise a flag the solver polls every few thousand
+// nodes, so the UI thread never waits for the search.
+//
+// Web builds have no threads: start() runs one small solve in place instead.
+class HintEngine {
+public:
+    explicit HintEngine(double timeBudgetSeconds = 3.0);
+    ~HintEngine();
+
+    HintEngine(const HintEngine&) = delete;
+    HintEngine& operator=(const HintEngine&) = delete;
+
+    // Starts searching game, dropping any search still running. The hint is
+    // tied to the game's state version.
+    void start(const Klondike& game);
+    // Stops the search and forgets its hint
+    void cancel();
+
+    // The best move so far for the last start(), if it was not cancelled
+    Hint best() const;
+    bool isSearching() const;
+    // State version of the game passed to the last start()
+    uint32_t getStateVersion() const { return stateVersion; }
+
+    // A cheap move choice from the rules alone: foundation moves first, then
+    // moves that turn over a card, then the stock
+    static bool ruleOfThumb(const Klondike& game, Move& move);
+
+private:
+    double timeBudgetSeconds;
+    uint32_t stateVersion;
+
+    mutable std::mutex mutex;  // Guards everything below, except cancelFlag
+    std::condition_variable wake;
+    Klondike snapshot;
+    uint64_t requested;  // Job number of the last start() or cancel()
+    uint64_t taken;      // Job number the worker is on
+    bool pending;        // snapshot holds a game the worker has not taken yet
+    bool running;        // The worker is searching job `taken`
+    bool quitting;
+    Hint hint;           // Best move for job `requested`, empty until the worker has one
+    uint32_t revisions;  // Last Hint::revision handed out
+    std::atomic<bool> cancelFlag;
+    std::thread worker;
+
+    void run();
+    void search(const Klondike& game, uint64_t job, Solver& solver);
+    // Stores hint if job is still the latest, returns false once it is not
+    bool publish(uint64_t job, const Hint& result);
+    void resetHint();  // Called with the mutex held
+};
@@ -0,0 +1,185 @@
+#include "Journal.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Whether entry can be applied (or reverted) to game without reading past a pile
+bool entryFits(const HistoryEntry& entry, const KlondikeState& game) {
+    bool reverted = (entry.flags & HistoryEntry::revertedFlag) != 0;
+    int source = entry.source();
+    int target = entry.target();
+    if (source >= PileCount || target >= PileCount || source == target) {
+        return false;
+    }
+    size_t stock = game.stock().size();
+    size_t waste = game.waste().size();
+    switch (entry.type) {
+        case MoveTypeCards:
+            if (entry.count == 0 || target == PileStock || target == PileWaste || source == PileStock) {
+                return false;
+            }
+            if (reverted) {
+                bool flipped = (entry.flags & HistoryEntry::flippedFlag) != 0;
+                return game.pile(target).size() >= entry.count && (!flipped || !game.pile(source).empty());
+            }
+            return game.pile(source).size() >= entry.count;
+        case MoveTypeDraw:
+            return entry.count > 0 && (reverted ? waste >= entry.count : stock >= entry.count);
+        case MoveTypeRecycle:
+            return reverted ? waste == 0 && stock > 0 : stock == 0 && waste > 0;
+    }
+    return false;
+}
+
+bool samePiles(const KlondikeState& a, const KlondikeState& b) {
+    for (int p = 0; p < PileCount; p++) {
+        const CardPile& pa = a.pile(p);
+        const CardPile& pb = b.pile(p);
+        if (pa.size() != pb.size() || std::memcmp(pa.data(), pb.data(), pa.size()) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+JournalWriter::JournalWriter() : interval(64), moves(0) {}
+
+bool JournalWriter::open(const std::string& path, const KlondikeState& game, int keyframeInterval) {
+    close();
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    interval = static_cast<uint16_t>(std::max(1, std::min(keyframeInterval, 65535)));
+    moves = 0;
+
+    JournalHeader header = {journalFileMagic, journalFileVersion, interval, game.getDealNumber()};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeKeyframe(game);
+    file.flush();
+    return file.good();
+}
+
+void JournalWriter::close() {
+    if (file.is_open()) {
+        file.close();
+    }
+}
+
+void JournalWriter::append(const HistoryEntry& entry, bool reverted, const KlondikeState& game) {
+    if (!file.is_open()) {
+        return;
+    }
+    HistoryEntry record = entry;
+    record.flags = static_cast<uint8_t>(reverted ? record.flags | HistoryEntry::revertedFlag
+                                                 : record.flags & ~HistoryEntry::revertedFlag);
+    file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    if (++moves % interval == 0) {
+        writeKeyframe(game);
+    }
+    file.flush();
+}
+
+void JournalWriter::writeKeyframe(const KlondikeState& game) {
+    HistoryEntry marker = {journalKeyframeType, 0, 0, 0};
+    SaveImage image;
+    SaveFormat::encode(game, image);
+    file.write(reinterpret_cast<const char*>(&marker), sizeof(marker));
+    file.write(reinterpret_cast<const char*>(&image), sizeof(image));
+}
+
+bool JournalReader::load(const std::string& path) {
+    records.clear();
+    keyframes.clear();
+    mismatches = 0;
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::vector<char> bytes(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(bytes.data(), bytes.size()) || bytes.size() < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic != journalFileMagic || header.version != journalFileVersion || header.keyframeInterval == 0) {
+        return false;
+    }
+
+    // Replay the whole journal once so that every record is known to fit
+    // the state it is applied to and seek() can trust them
+    KlondikeState game;
+    size_t offset = sizeof(header);
+    while (offset + sizeof(HistoryEntry) <= bytes.size()) {
+        HistoryEntry entry;
+        std::memcpy(&entry, bytes.data() + offset, sizeof(entry));
+        offset += sizeof(entry);
+
+        if (entry.type == journalKeyframeType) {
+            if (offset + sizeof(SaveImage) > bytes.size()) {
+                break;
+            }
+            Keyframe keyframe;
+            keyframe.moveIndex = records.size();
+            std::memcpy(&keyframe.image, bytes.data() + offset, sizeof(SaveImage));
+            offset += sizeof(SaveImage);
+
+            KlondikeState restored;
+            if (!SaveFormat::decode(keyframe.image, restored)) {
+                return false;
+            }
+            if (!keyframes.empty() && !samePiles(game, restored)) {
+                mismatches++;
+            }
+            keyframes.push_back(keyframe);
+            game = restored;
+            continue;
+        }
+
+        if (keyframes.empty() || !entryFits(entry, game)) {
+            return false;
+        }
+        records.push_back(entry);
+        step(records.size() - 1, game);
+    }
+    return !keyframes.empty();
+}
+
+bool JournalReader::seek(size_t moveIndex, KlondikeState& game) const {
+    if (moveIndex > records.size() || keyframes.empty()) {
+        return false;
+    }
+    // Last keyframe at or before moveIndex
+    auto next = std::upper_bound(keyframes.begin(), keyframes.end(), moveIndex,
+                                 [](size_t index, const Keyframe& keyframe) { return index < keyframe.moveIndex; });
+    const Keyframe& keyframe = *(next - 1);
+    if (!SaveFormat::decode(keyframe.image, game)) {
+        return false;
+    }
+    for (size_t i = keyframe.moveIndex; i < moveIndex; i++) {
+        step(i, game);
+    }
+    return true;
+}
+
+void JournalReader::step(size_t index, KlondikeState& game) const {
+    const HistoryEntry& entry = records[index];
+    if (entry.flags & HistoryEntry::revertedFlag) {
+        game.revertEntry(entry);
+    } else {
+        game.applyEntry(entry);
+    }
+}
+
+void JournalReader::stepBack(size_t index, KlondikeState& game) const {
+    const HistoryEntry& entry = records[index];
+    if (entry.flags & HistoryEntry::revertedFlag) {
+        game.applyEntry(entry);
+    } else {
+        game.revertEntry(entry);
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "Klondike.h"
+#include "SaveFormat.h"
+
+// Journal file layout, little endian:
+//   JournalHeader
+//   a stream of 4-byte HistoryEntry records, one per state change. A record
+//   whose type is journalKeyframeType is followed by a SaveImage holding the
+//   whole game at that point and does not count as a move.
+// The first record is always a keyframe with the starting state. Undos are
+// journaled as the undone entry with HistoryEntry::revertedFlag set, so every
+// record can be applied or reverted without the undo history.
+const uint32_t journalFileMagic = 0x4E524A4B;  // "KJRN"
+const uint16_t journalFileVersion = 1;
+const uint8_t journalKeyframeType = 0xFF;
+
+struct JournalHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t keyframeInterval;  // Moves between two keyframes
+    uint32_t dealNumber;        // Deal the journal started from, for reference
+};
+
+static_assert(sizeof(JournalHeader) == 12, "JournalHeader layout changed");
+
+// Appends the changes of a live game to a journal file. Attach it with
+// Klondike::setJournal(); the file is flushed after every record so a crash
+// loses nothing the player did.
+class JournalWriter {
+public:
+    JournalWriter();
+
+    // Starts a new journal with the current state of game as its first keyframe
+    bool open(const std::string& path, const KlondikeState& game, int keyframeInterval = 64);
+    void close();
+    bool isOpen() const { return file.is_open(); }
+
+    // Appends a change, game is the state after it
+    void append(const HistoryEntry& entry, bool reverted, const KlondikeState& game);
+    size_t size() const { return moves; }
+
+private:
+    std::ofstream file;
+    uint16_t interval;
+    size_t moves;
+
+    void writeKeyframe(const KlondikeState& game);
+};
+
+// A journal loaded into memory. Any move index is reached by restoring the
+// closest earlier keyframe and replaying at most keyframeInterval - 1 moves.
+class JournalReader {
+public:
+    // Reads the whole file with one read. A torn last record is ignored.
+    // Returns false if the file is not a journal or a record does not fit the
+    // state it would be applied to.
+    bool load(const std::string& path);
+
+    size_t size() const { return records.size(); }
+    size_t keyframeCount() const { return keyframes.size(); }
+    // Keyframes that disagree with the replayed moves before them; nonzero
+    // means the game that wrote the journal had a rules bug
+    size_t mismatchCount() const { return mismatches; }
+    const JournalHeader& getHeader() const { return header; }
+    const HistoryEntry& record(size_t index) const { return records[index]; }
+
+    // Sets game to the state after the first moveIndex moves
+    bool seek(size_t moveIndex, KlondikeState& game) const;
+    // Applies move index to a game in the state before it, or reverts it from
+    // the state after it
+    void step(size_t index, KlondikeState& game) const;
+    void stepBack(size_t index, KlondikeState& game) const;
+
+private:
+    struct Keyframe {
+        size_t moveIndex;  // Moves replayed before this keyframe
+        SaveImage image;
+    };
+
+    JournalHeader header;
+    std::vector<HistoryEntry> records;
+    std::vector<Keyframe> keyframes;
+    size_t mismatches = 0;
+};
@@ -0,0 +1,345 @@
+#include "Klondike.h"
+#include "Journal.h"
+#include "Random.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+KlondikeState::KlondikeState() : dealNumber(0), stateVersion(0), historyPosition(0) {}
+
+void KlondikeState::clear() {
+    for (auto& pile : piles) {
+        pile.clear();
+    }
+    history.clear();
+    historyPosition = 0;
+    stateVersion++;
+}
+
+void KlondikeState::shuffledDeck(uint32_t dealNumber, Card deck[cardDeckSize]) {
+    static const struct SortedDeck {
+        Card cards[cardDeckSize];
+        SortedDeck() {
+            for (int i = 0; i < cardDeckSize; i++) {
+                cards[i] = Card::fromIndex(i);
+            }
+        }
+    } sorted;
+    std::memcpy(deck, sorted.cards, sizeof(sorted.cards));
+
+    // Fisher-Yates with a generator seeded only by the deal number, drawing
+    // two swap positions per generator call
+    Xoshiro256 rng(dealNumber);
+    int i = cardDeckSize - 1;
+    for (; i > 1; i -= 2) {
+        uint32_t j, k;
+        rng.belowPair(i + 1, i, j, k);
+        std::swap(deck[i], deck[j]);
+        std::swap(deck[i - 1], deck[k]);
+    }
+    if (i == 1) {
+        std::swap(deck[1], deck[rng.below(2)]);
+    }
+}
+
+void KlondikeState::newGame(uint32_t number) {
+    clear();
+    dealNumber = number;
+
+    Card deck[cardDeckSize];
+    shuffledDeck(number, deck);
+    piles[PileStock].assign(deck, deck + cardDeckSize);
+
+    dealCards();
+}
+
+void KlondikeState::dealCards() {
+    stateVersion++;
+    CardPile& stock = piles[PileStock];
+
+    // Deal cards to tableau piles
+    for (int i = 0; i < tableauPileCount; i++) {
+        for (int j = i; j < tableauPileCount; j++) {
+            if (!stock.empty()) {
+                Card card = stock.back();
+                stock.pop_back();
+                // The first card added to each pile (when j == i) should be face up
+                card.setFaceUp(j == i);
+                // Add to back of vector (top of pile)
+                piles[PileTableau0 + j].push_back(card);
+            }
+        }
+    }
+}
+
+bool KlondikeState::drawCards(int count) {
+    if (piles[PileStock].empty()) {
+        return false;
+    }
+
+    count = std::min(count, static_cast<int>(piles[PileStock].size()));
+    turnStockCards(count);
+    record(MoveTypeDraw, PileStock, PileWaste, count, false);
+    return true;
+}
+
+bool KlondikeState::recycleWaste() {
+    // Only restore waste cards if stock is empty and waste is not empty
+    if (!piles[PileStock].empty() || piles[PileWaste].empty()) {
+        return false;
+    }
+
+    int count = static_cast<int>(piles[PileWaste].size());
+    turnWaste();
+    record(MoveTypeRecycle, PileWaste, PileStock, count, false);
+    return true;
+}
+
+bool KlondikeState::undoDraw() {
+    // Only while the draw is still the last change; the waste top may have
+    // been drawn earlier with other moves made since
+    if (!canUndoDraw()) {
+        return false;
+    }
+    return undo();
+}
+
+void KlondikeState::turnStockCards(int count) {
+    // One card at a time, so the last card turned ends on top like a turned packet
+    for (int i = 0; i < count; i++) {
+        Card card = piles[PileStock].back();
+        piles[PileStock].pop_back();
+        card.setFaceUp(true);
+        piles[PileWaste].push_back(card);
+    }
+}
+
+void KlondikeState::turnWaste() {
+    CardPile& stock = piles[PileStock];
+    CardPile& waste = piles[PileWaste];
+    while (!waste.empty()) {
+        Card card = waste.back();
+        waste.pop_back();
+        card.setFaceUp(false);
+        stock.push_back(card);
+    }
+}
+
+template <class Rules>
+bool BasicKlondike<Rules>::canMoveToTableau(Card card, const CardPile& targetPile) const {
+    if (targetPile.empty()) {
+        return Rules::startsTableau(card);
+    }
+    return Rules::stacksOnTableau(card, targetPile.back());
+}
+
+template <class Rules>
+bool BasicKlondike<Rules>::canMoveToFoundation(Card card, const CardPile& targetPile) const {
+    if (targetPile.empty()) {
+        return Rules::startsFoundation(card);
+    }
+    return Rules::stacksOnFoundation(card, targetPile.back());
+}
+
+template <class Rules>
+bool BasicKlondike<Rules>::canMove(int sourcePile, int startIndex, int targetPile) const {
+    if (sourcePile < 0 || sourcePile >= PileCount || targetPile < 0 || targetPile >= PileCount) {
+        return false;
+    }
+    // Cards never go back to their own pile, the stock or the waste
+    if (sourcePile == targetPile || targetPile == PileStock || targetPile == PileWaste) {
+        return false;
+    }
+    // The stock is never a drag source
+    if (sourcePile == PileStock) {
+        return false;
+    }
+
+    const CardPile& source = pile(sourcePile);
+    if (startIndex < 0 || startIndex >= static_cast<int>(source.size()) || !source[startIndex].isFaceUp()) {
+        return false;
+    }
+    // Only the top card can leave the waste or a foundation
+    int count = static_cast<int>(source.size()) - startIndex;
+    if (!isTableauPile(sourcePile) && count != 1) {
+        return false;
+    }
+
+    Card card = source[startIndex];
+    if (isFoundationPile(targetPile)) {
+        // Only single cards can be moved to foundation
+        return count == 1 && canMoveToFoundation(card, pile(targetPile));
+    }
+    return canMoveToTableau(card, pile(targetPile));
+}
+
+template <class Rules>
+int BasicKlondike<Rules>::findValidFoundationPile(Card card) const {
+    for (int i = 0; i < foundationPileCount; i++) {
+        if (canMoveToFoundation(card, pile(PileFoundation0 + i))) {
+            return PileFoundation0 + i;
+        }
+    }
+    return noPile;
+}
+
+void KlondikeState::foundationHeights(uint8_t heights[cardSuitCount]) const {
+    for (int s = 0; s < cardSuitCount; s++) {
+        heights[s] = 0;
+    }
+    for (int i = 0; i < foundationPileCount; i++) {
+        const CardPile& foundation = piles[PileFoundation0 + i];
+        if (!foundation.empty()) {
+            heights[foundation.back().getSuit()] = static_cast<uint8_t>(foundation.back().getValue());
+        }
+    }
+}
+
+bool KlondikeState::checkWin() const {
+    for (int i = 0; i < foundationPileCount; i++) {
+        const CardPile& foundation = piles[PileFoundation0 + i];
+        if (foundation.empty() || foundation.back().getValue() != 13) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool KlondikeState::moveCards(int sourcePile, int targetPile, int startIndex) {
+    int count = static_cast<int>(piles[sourcePile].size()) - startIndex;
+    if (startIndex < 0 || count <= 0) {
+        return false;
+    }
+
+    bool flipped = moveRun(sourcePile, targetPile, startIndex);
+    record(MoveTypeCards, sourcePile, targetPile, count, flipped);
+    return true;
+}
+
+bool KlondikeState::moveRun(int sourcePile, int targetPile, int startIndex) {
+    CardPile& source = piles[sourcePile];
+    CardPile& target = piles[targetPile];
+    target.append(source.begin() + startIndex, source.end());
+    source.resize(startIndex);
+
+    // Flip the new top card of the source pile if it exists
+    if (!source.empty() && !source.back().isFaceUp()) {
+        source.back().flip();
+        return true;
+    }
+    return false;
+}
+
+void KlondikeState::record(MoveType type, int sourcePile, int targetPile, int count, bool flipped) {
+    HistoryEntry entry;
+    entry.type = type;
+    entry.piles = static_cast<uint8_t>(sourcePile | (targetPile << 4));
+    entry.count = static_cast<uint8_t>(count);
+    entry.flags = flipped ? HistoryEntry::flippedFlag : 0;
+    // A new move replaces whatever could have been redone
+    history.resize(historyPosition);
+    history.push_back(entry);
+    historyPosition++;
+    stateVersion++;
+    journal(entry, false);
+}
+
+bool KlondikeState::undo() {
+    if (historyPosition == 0) {
+        return false;
+    }
+    const HistoryEntry& entry = history[--historyPosition];
+    revertEntry(entry);
+    journal(entry, true);
+    return true;
+}
+
+bool KlondikeState::redo() {
+    if (historyPosition == history.size()) {
+        return false;
+    }
+    const HistoryEntry& entry = history[historyPosition++];
+    applyEntry(entry);
+    journal(entry, false);
+    return true;
+}
+
+void KlondikeState::applyEntry(const HistoryEntry& entry) {
+    stateVersion++;
+    switch (entry.type) {
+        case MoveTypeCards:
+            moveRun(entry.source(), entry.target(), static_cast<int>(piles[entry.source()].size()) - entry.count);
+            break;
+        case MoveTypeDraw:
+            turnStockCards(entry.count);
+            break;
+        case MoveTypeRecycle:
+            turnWaste();
+            break;
+    }
+}
+
+void KlondikeState::revertEntry(const HistoryEntry& entry) {
+    stateVersion++;
+    switch (entry.type) {
+        case MoveTypeCards: {
+            CardPile& source = piles[entry.source()];
+            CardPile& target = piles[entry.target()];
+            if (entry.flags & HistoryEntry::flippedFlag) {
+                source.back().flip();
+            }
+            source.append(target.end() - entry.count, target.end());
+            target.resize(target.size() - entry.count);
+            break;
+        }
+        case MoveTypeDraw:
+            for (int i = 0; i < entry.count; i++) {
+                Card card = piles[PileWaste].back();
+                piles[PileWaste].pop_back();
+                card.setFaceUp(false);
+                piles[PileStock].push_back(card);
+            }
+            break;
+        case MoveTypeRecycle: {
+            CardPile& stock = piles[PileStock];
+            CardPile& waste = piles[PileWaste];
+            while (!stock.empty()) {
+                Card card = stock.back();
+                stock.pop_back();
+                card.setFaceUp(true);
+                waste.push_back(card);
+            }
+            break;
+        }
+    }
+}
+
+void KlondikeState::journal(const HistoryEntry& entry, bool reverted) {
+    if (journalLink.writer) {
+        journalLink.writer->append(entry, reverted, *this);
+    }
+}
+
+template <class Rules>
+bool BasicKlondike<Rules>::tryMove(int sourcePile, int startIndex, int targetPile) {
+    if (!canMove(sourcePile, startIndex, targetPile)) {
+        return false;
+    }
+    return moveCards(sourcePile, targetPile, startIndex);
+}
+
+template <class Rules>
+bool BasicKlondike<Rules>::applyMove(const Move& move) {
+    switch (move.type) {
+        case MoveTypeCards:
+            return tryMove(move.source, move.startIndex, move.target);
+        case MoveTypeDraw:
+            return drawFromStock();
+        case MoveTypeRecycle:
+            return recycleWaste();
+    }
+    return false;
+}
+
+template class BasicKlondike<DrawOneRules>;
+template class BasicKlondike<DrawThreeRules>;
@@ -0,0 +1,196 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Card.h"
+#include "CardPile.h"
+#include "KlondikeRules.h"
+
+// Pile identifiers shared by the rules engine, the UI and the tools
+enum PileId : uint8_t {
+    PileTableau0 = 0,       // Tableau piles are PileTableau0 .. PileTableau0 + 6
+    PileFoundation0 = 7,    // Foundation piles are PileFoundation0 .. PileFoundation0 + 3
+    PileStock = 11,
+    PileWaste = 12,
+    PileCount = 13
+};
+
+const int tableauPileCount = 7;
+const int foundationPileCount = 4;
+const int noPile = -1;
+
+inline bool isTableauPile(int pile) { return pile >= PileTableau0 && pile < PileTableau0 + tableauPileCount; }
+inline bool isFoundationPile(int pile) { return pile >= PileFoundation0 && pile < PileFoundation0 + foundationPileCount; }
+
+// A foundation move is safe when both opposite-colour foundations already hold
+// the cards that could be placed on this one, so it is never needed on the
+// tableau. heights[suit] is the rank on top of that suit's foundation, 0 when
+// it is empty. Shared by the solver and the auto-play.
+inline bool isSafeFoundationCard(Card card, const uint8_t heights[cardSuitCount]) {
+    int value = card.getValue();
+    int opposite = card.isRed() ? SuitClubs : SuitHearts;
+    return value <= 2 || (heights[opposite] >= value - 1 && heights[opposite + 1] >= value - 1);
+}
+
+// A single player action, as produced by the solver and replayed by the engine
+enum MoveType : uint8_t {
+    MoveTypeCards = 0,   // Cards from startIndex to the top of source go onto target
+    MoveTypeDraw = 1,    // Turn stock cards onto the waste, as many as the rules draw
+    MoveTypeRecycle = 2  // Turn the waste back into the stock
+};
+
+struct Move {
+    uint8_t type;
+    uint8_t source;
+    uint8_t startIndex;
+    uint8_t target;
+
+    static Move cards(int source, int startIndex, int target) {
+        return {MoveTypeCards, static_cast<uint8_t>(source), static_cast<uint8_t>(startIndex), static_cast<uint8_t>(target)};
+    }
+    static Move draw() { return {MoveTypeDraw, PileStock, 0, PileWaste}; }
+    static Move recycle() { return {MoveTypeRecycle, PileWaste, 0, PileStock}; }
+};
+
+// One undo history record. Only what the state after the move cannot tell is
+// kept, so undoing or redoing touches just the cards that moved.
+struct HistoryEntry {
+    static const uint8_t flippedFlag = 1;   // The move turned the new top of the source face up
+    static const uint8_t revertedFlag = 4;  // Journal only: the move was undone
+    // Bit 2 is unused; journals written before it was dropped may still set it
+
+    uint8_t type;   // MoveType
+    uint8_t piles;  // Source pile in the low nibble, target pile in the high nibble
+    uint8_t count;  // Number of cards moved
+    uint8_t flags;
+
+    int source() const { return piles & 0x0F; }
+    int target() const { return piles >> 4; }
+};
+
+static_assert(sizeof(HistoryEntry) == 4, "HistoryEntry layout changed");
+
+class JournalWriter;
+
+// Klondike cards, deal and undo history, shared by every rule set. This class
+// has no rendering, input or timing dependencies so it can be linked into
+// headless tools and run at simulation speed; it never checks a rule, that is
+// left to BasicKlondike. Journals and save files work on this part alone.
+class KlondikeState {
+public:
+    KlondikeState();
+
+    // Deals game number dealNumber. The same number always gives the same deal.
+    void newGame(uint32_t dealNumber);
+    // Writes the shuffled deck of a deal, dealt from the back like the stock
+    static void shuffledDeck(uint32_t dealNumber, Card deck[cardDeckSize]);
+    // Empties every pile and the undo history
+    void clear();
+    // Deals the tableau from the stock, leaving the rest of the deck in the stock
+    void dealCards();
+
+    // Stock handling
+    bool recycleWaste();    // Turns the whole waste back into the stock, only when the stock is empty
+    bool undoDraw();        // Undoes the last move if it was a stock turn
+    bool canUndoDraw() const { return historyPosition > 0 && history[historyPosition - 1].type == MoveTypeDraw; }
+
+    // Rank on top of each suit's foundation, 0 for a suit with no foundation yet
+    void foundationHeights(uint8_t heights[cardSuitCount]) const;
+    bool checkWin() const;
+
+    // Moves the cards from startIndex to the top of sourcePile without checking
+    // the rules and flips the new top card of the source pile
+    bool moveCards(int sourcePile, int targetPile, int startIndex);
+
+    CardPile& pile(int id) { return piles[id]; }
+    const CardPile& pile(int id) const { return piles[id]; }
+    const CardPile& tableau(int i) const { return piles[PileTableau0 + i]; }
+    const CardPile& foundation(int i) const { return piles[PileFoundation0 + i]; }
+    const CardPile& stock() const { return piles[PileStock]; }
+    const CardPile& waste() const { return piles[PileWaste]; }
+
+    // Undo history of every state change since the deal. A new move drops the
+    // undone moves that could still have been redone.
+    bool undo();
+    bool redo();
+    bool canUndo() const { return historyPosition > 0; }
+    bool canRedo() const { return historyPosition < history.size(); }
+    size_t historySize() const { return history.size(); }
+    // Entries before undoCount() are the changes that led to the current state
+    const HistoryEntry& historyEntry(size_t i) const { return history[i]; }
+    size_t undoCount() const { return historyPosition; }
+    size_t historyBytes() const { return history.capacity() * sizeof(HistoryEntry); }
+
+    // Replays or reverts a recorded change without touching the undo history.
+    // The entry must have been recorded in the state it is applied to.
+    void applyEntry(const HistoryEntry& entry);
+    void revertEntry(const HistoryEntry& entry);
+
+    // Every later state change, undo and redo is appended to journal. Copies
+    // of this game are not journaled.
+    void setJournal(JournalWriter* journal) { journalLink.writer = journal; }
+
+    uint32_t getDealNumber() const { return dealNumber; }
+    void setDealNumber(uint32_t number) { dealNumber = number; }
+
+    // Changes whenever the piles may have changed: on every move, undo, redo,
+    // deal and clear(). Writing through pile() is not counted, callers that do
+    // so start with clear().
+    uint32_t getStateVersion() const { return stateVersion; }
+
+protected:
+    // Turns up to count stock cards onto the waste as one move, the last one
+    // ending on top. Returns false if the stock is empty.
+    bool drawCards(int count);
+
+private:
+    CardPile piles[PileCount];
+    uint32_t dealNumber;
+    uint32_t stateVersion;
+    std::vector<HistoryEntry> history;
+    size_t historyPosition;  // Entries before this one can be undone, the rest redone
+
+    // Journal pointer that stays with the original object when the game is copied
+    struct JournalLink {
+        JournalWriter* writer = nullptr;
+        JournalLink() {}
+        JournalLink(const JournalLink&) {}
+        JournalLink& operator=(const JournalLink&) { return *this; }
+    } journalLink;
+
+    bool moveRun(int sourcePile, int targetPile, int startIndex);  // Returns whether a card was flipped
+    void turnStockCards(int count);
+    void turnWaste();
+    void record(MoveType type, int sourcePile, int targetPile, int count, bool flipped);
+    void journal(const HistoryEntry& entry, bool reverted);
+};
+
+// Klondike played by the rules of Rules (see KlondikeRules.h). The member
+// functions are compiled once per rule set in Klondike.cpp.
+template <class Rules>
+class BasicKlondike : public KlondikeState {
+public:
+    typedef Rules RuleSet;
+
+    // Turns Rules::drawCount stock cards, or what is left, onto the waste
+    bool drawFromStock() { return drawCards(Rules::drawCount); }
+
+    // Rule checks
+    bool canMoveToTableau(Card card, const CardPile& targetPile) const;
+    bool canMoveToFoundation(Card card, const CardPile& targetPile) const;
+    // Whether the cards from startIndex to the top of sourcePile may be dropped on targetPile
+    bool canMove(int sourcePile, int startIndex, int targetPile) const;
+    // Returns the foundation pile the card can go to, or noPile
+    int findValidFoundationPile(Card card) const;
+
+    // Moves the cards from startIndex to the top of sourcePile if canMove() allows it
+    bool tryMove(int sourcePile, int startIndex, int targetPile);
+    // Applies a move if it is legal in the current state
+    bool applyMove(const Move& move);
+};
+
+extern template class BasicKlondike<DrawOneRules>;
+extern template class BasicKlondike<DrawThreeRules>;
+
+// The game, the hint engine and the save files play draw-one
+typedef BasicKlondike<DrawOneRules> Klondike;
+typedef BasicKlondike<DrawThreeRules> KlondikeDrawThree;
@@ -0,0 +1,39 @@
+#pragma once
+#include "Card.h"
+
+// Rule policies for the Klondike engine and solver. BasicKlondike and
+// BasicSolver take one as a template parameter; every check is a static
+// inline function, so each rule set gets its own compiled move generator and
+// legality checks with no virtual call or variant flag on the hot path.
+//
+// Draw-one and draw-three differ only in how many cards a stock turn moves,
+// with unlimited redeals in both.
+template <int cardsPerDraw>
+struct KlondikeRules {
+    static const int drawCount = cardsPerDraw;
+
+    // Whether card may start an empty tableau pile
+    static bool startsTableau(Card card) { return card.getValue() == cardRankCount; }
+    // Whether card may go onto a tableau pile whose top card is top
+    static bool stacksOnTableau(Card card, Card top) { return Card::stacksOnTableau(card, top); }
+    static bool startsFoundation(Card card) { return card.getValue() == 1; }
+    static bool stacksOnFoundation(Card card, Card top) { return Card::stacksOnFoundation(card, top); }
+
+    // Whether talon position index can become the waste top by turning the
+    // stock, without playing any other card first. The talon is the waste from
+    // bottom to top followed by the stock in draw order; cursor is the
+    // position of the waste top, -1 when the waste is empty. A short last
+    // turn always shows the final card.
+    static bool talonReachable(int index, int cursor, int talonSize) {
+        if (index == cursor || index == talonSize - 1) {
+            return true;
+        }
+        if (index > cursor && (index - cursor) % drawCount == 0) {
+            return true;  // Turned up before the stock runs out
+        }
+        return (index + 1) % drawCount == 0;  // Turned up after recycling the waste
+    }
+};
+
+typedef KlondikeRules<1> DrawOneRules;
+typedef KlondikeRules<3> DrawThreeRules;
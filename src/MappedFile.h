@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Read-only view of a whole file. The file is memory mapped where the
+// platform allows it, so pages are only read when touched; elsewhere (and
+// on the web) it is read into a buffer with a single read.
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    const uint8_t* data() const { return bytes; }
+    size_t size() const { return length; }
+    bool isMapped() const { return mapped; }
+
+private:
+    const uint8_t* bytes;
+    size_t length;
+    bool mapped;
+    std::vector<uint8_t> buffer;  // Contents when the file could not be mapped
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+
+    bool map(const std::string& path);
+    bool readAll(const std::string& path);
+};
@@ -0,0 +1,6 @@
+#pragma once
+
+// CPU time this process has used so far, user plus system, in seconds.
+// Divided by the wall time of the same interval it gives the share of one
+// core the process kept busy.
+double processCpuSeconds();
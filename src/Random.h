@@ -0,0 +1,111 @@
+#pragma once
+#include <cstdint>
+
+// SplitMix64, used to expand a single seed into generator state
+inline uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// xoshiro256** by Blackman and Vigna. Small, fast and splittable: jump()
+// advances the stream by 2^128 draws, so worker i of a parallel job can start
+// from the same seed jumped i times and never overlap another worker.
+class Xoshiro256 {
+public:
+    typedef uint64_t result_type;
+
+    explicit Xoshiro256(uint64_t seed = 0) { reseed(seed); }
+
+    void reseed(uint64_t seed) {
+        for (auto& word : s) {
+            word = splitMix64(seed);
+        }
+    }
+
+    static constexpr uint64_t min() { return 0; }
+    static constexpr uint64_t max() { return UINT64_MAX; }
+
+    uint64_t operator()() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // Unbiased integer in [0, bound) using Lemire's multiply-shift method
+    uint32_t below(uint32_t bound) {
+        uint32_t result;
+        while (!fromBits(uint32_t((*this)() >> 32), bound, result)) {
+        }
+        return result;
+    }
+
+    // Two unbiased integers from a single draw, each half of the output
+    // feeding one bound. Halves the generator calls of a shuffle.
+    void belowPair(uint32_t boundA, uint32_t boundB, uint32_t& a, uint32_t& b) {
+        uint64_t x = (*this)();
+        if (!fromBits(uint32_t(x >> 32), boundA, a)) {
+            a = below(boundA);
+        }
+        if (!fromBits(uint32_t(x), boundB, b)) {
+            b = below(boundB);
+        }
+    }
+
+    // Uniform double in [0, 1)
+    double uniform() { return ((*this)() >> 11) * (1.0 / 9007199254740992.0); }
+
+    // Equivalent to 2^128 calls to operator()
+    void jump() {
+        static const uint64_t jumpPolynomial[] = {0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull,
+                                                  0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull};
+        applyJump(jumpPolynomial);
+    }
+
+    // Equivalent to 2^192 calls to operator()
+    void longJump() {
+        static const uint64_t longJumpPolynomial[] = {0x76E15D3EFEFDCBBFull, 0xC5004E441C522FB3ull,
+                                                      0x77710069854EE241ull, 0x39109BB02ACBE635ull};
+        applyJump(longJumpPolynomial);
+    }
+
+private:
+    uint64_t s[4];
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    // Maps 32 random bits to [0, bound), failing for the few inputs that would bias it
+    static bool fromBits(uint32_t bits, uint32_t bound, uint32_t& result) {
+        uint64_t m = uint64_t(bits) * bound;
+        uint32_t low = uint32_t(m);
+        if (low < bound && low < uint32_t(-bound) % bound) {
+            return false;
+        }
+        result = uint32_t(m >> 32);
+        return true;
+    }
+
+    void applyJump(const uint64_t* polynomial) {
+        uint64_t t[4] = {0, 0, 0, 0};
+        for (int i = 0; i < 4; i++) {
+            for (int b = 0; b < 64; b++) {
+                if (polynomial[i] & (uint64_t(1) << b)) {
+                    for (int w = 0; w < 4; w++) {
+                        t[w] ^= s[w];
+                    }
+                }
+                (*this)();
+            }
+        }
+        for (int w = 0; w < 4; w++) {
+            s[w] = t[w];
+        }
+    }
+};
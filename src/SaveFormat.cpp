@@ -0,0 +1,88 @@
+#include "SaveFormat.h"
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+
+uint32_t SaveFormat::checksum(const SaveImage& image) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&image);
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < offsetof(SaveImage, checksum); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+void SaveFormat::encode(const KlondikeState& game, SaveImage& image) {
+    std::memset(&image, 0, sizeof(image));
+    image.magic = saveFileMagic;
+    image.version = saveFileVersion;
+    image.dealNumber = game.getDealNumber();
+
+    int count = 0;
+    for (int p = 0; p < PileCount; p++) {
+        const CardPile& pile = game.pile(p);
+        image.pileSizes[p] = static_cast<uint8_t>(pile.size());
+        for (Card card : pile) {
+            if (count < cardDeckSize) {
+                image.cards[count++] = card.bits;
+            }
+        }
+    }
+    image.checksum = checksum(image);
+}
+
+bool SaveFormat::decode(const SaveImage& image, KlondikeState& game) {
+    if (image.magic != saveFileMagic || image.version != saveFileVersion || image.checksum != checksum(image)) {
+        return false;
+    }
+
+    int total = 0;
+    for (int p = 0; p < PileCount; p++) {
+        total += image.pileSizes[p];
+    }
+    if (total != cardDeckSize) {
+        return false;
+    }
+
+    // Every card of the deck exactly once
+    const uint8_t unusedBits = static_cast<uint8_t>(~(Card::rankMask | Card::suitMask | Card::faceUpMask));
+    uint64_t seen = 0;
+    for (int i = 0; i < cardDeckSize; i++) {
+        Card card = Card::fromBits(image.cards[i]);
+        if ((image.cards[i] & unusedBits) || card.getValue() < 1 || card.getValue() > cardRankCount) {
+            return false;
+        }
+        uint64_t bit = uint64_t(1) << card.getIndex();
+        if (seen & bit) {
+            return false;
+        }
+        seen |= bit;
+    }
+
+    game.clear();
+    game.setDealNumber(image.dealNumber);
+    const uint8_t* next = image.cards;
+    for (int p = 0; p < PileCount; p++) {
+        CardPile& pile = game.pile(p);
+        for (int i = 0; i < image.pileSizes[p]; i++) {
+            pile.push_back(Card::fromBits(*next++));
+        }
+    }
+    return true;
+}
+
+bool SaveFormat::write(const std::string& path, const KlondikeState& game) {
+    SaveImage image;
+    encode(game, image);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    return file.write(reinterpret_cast<const char*>(&image), sizeof(image)).good();
+}
+
+bool SaveFormat::read(const std::string& path, KlondikeState& game) {
+    SaveImage image;
+    std::ifstream file(path, std::ios::binary);
+    if (!file.read(reinterpret_cast<char*>(&image), sizeof(image))) {
+        return false;
+    }
+    return decode(image, game);
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "Klondike.h"
+
+// Saved game layout, little endian, one fixed-size block:
+//   SaveImage with the pile lengths in PileId order and then the cards of
+//   every pile from bottom to top, one Card byte each
+// The checksum is FNV-1a over every byte before it.
+const uint32_t saveFileMagic = 0x5641534B;  // "KSAV"
+const uint16_t saveFileVersion = 1;
+
+struct SaveImage {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t dealNumber;
+    uint8_t pileSizes[PileCount];
+    uint8_t padding[3];
+    uint8_t cards[cardDeckSize];
+    uint32_t checksum;
+};
+
+static_assert(sizeof(SaveImage) == 84, "SaveImage layout changed");
+
+// Binary save games. A save is read and written with a single call and
+// decoding allocates nothing, the piles hold their cards inline.
+class SaveFormat {
+public:
+    static void encode(const KlondikeState& game, SaveImage& image);
+    // Returns false and leaves game untouched unless the image holds a valid deck
+    static bool decode(const SaveImage& image, KlondikeState& game);
+
+    static bool write(const std::string& path, const KlondikeState& game);
+    static bool read(const std::string& path, KlondikeState& game);
+
+    static uint32_t checksum(const SaveImage& image);
+};
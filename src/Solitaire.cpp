@@ -1,7 +1,8 @@
 #include "Solitaire.h"
+#include "SaveFormat.h"
+#include "Trace.h"
 #include <algorithm>
 #include <random>
-#include <ctime>
 #include <iostream>
 #include <fstream>
 
@@ -17,267 +18,90 @@ using json = nlohmann::json;
 
 extern float gameScale;
 
-Solitaire::Solitaire() {
-    // Initialize random seed
-    srand(time(NULL));
+static const char* saveFilePath = "solitaire_save.bin";
+static const char* legacySaveFilePath = "solitaire_save.txt";  // JSON saves from older versions, read only
+static const char* journalFilePath = "solitaire_journal.bin";  // Every move of the current game, see klondike-replay
 
+Solitaire::Solitaire() : dealPicker(std::random_device{}()) {
     // Initialize game state
     menuOpen = false;
     helpMenuOpen = false;
     shouldClose = false;
     aboutDialogOpen = false;
     gameWon = false;
-    draggedSourcePile = nullptr;
-    lastDrawnCard = nullptr;
+    draggedSourcePile = noPile;
+    draggedStartIndex = 0;
+    draggedVersion = 0;
+    shownHintRevision = 0;
+    autoPlayPending = false;
+    autoCompleting = false;
     lastDealTime = 0.0;
+    klondike.setJournal(&journal);
 
-    // Initialize piles
-    tableau.resize(7);
-    foundations.resize(4);
+    showRenderStats = false;
+    boardLayer = RenderTexture2D();
+    boardLayerVersion = 0;
+    boardLayerSourcePile = noPile;
+    boardLayerStartIndex = 0;
+    redrawNeeded = true;
+    drawnVersion = 0;
+    loopStats = {};
 
     // Load cards
-    std::string currentDir = GetWorkingDirectory();
-    std::string cardBackPath = "assets/cards/card_back_red.png";
-    if (!FileExists(cardBackPath.c_str())) {
-        cardBackPath = currentDir + "/assets/cards/card_back_red.png";
-    }
-    Card::loadCardBack(cardBackPath);
     loadCards();
+    // Mapped, not read: New Winnable Game only touches the page it picks from
+    if (winnableDeals.open(CardRenderer::getAssetPath("winnable.db")) && winnableDeals.getHeader().drawCount != 1) {
+        winnableDeals.close();
+    }
     resetGame();
 }
 
 Solitaire::~Solitaire() {
     // Clean up all textures
-    Card::unloadAllTextures();
-}
-
-void Solitaire::resetGame() {
-    // Clear all piles but keep the textures
-    for (auto& pile : tableau) {
-        pile.clear();
-    }
-    for (auto& pile : foundations) {
-        pile.clear();
-    }
-    stock.clear();
-    waste.clear();
-    draggedCards.clear();
-    draggedSourcePile = nullptr;
-    gameWon = false;
-
-    // Initialize tableau and foundations
-    tableau.resize(7);
-    foundations.resize(4);
-
-    // Create a new deck by reusing existing textures
-    const std::string suits[] = {"hearts", "diamonds", "clubs", "spades"};
-    const std::string values[] = {"ace", "2", "3", "4", "5", "6", "7", "8", "9", "10", "jack", "queen", "king"};
-
-    for (const auto& suit : suits) {
-        for (const auto& value : values) {
-            std::string imagePath = "assets/cards/" + value + "_of_" + suit + ".png";
-            stock.emplace_back(suit, value, imagePath);
-        }
+    if (boardLayer.id != 0) {
+        UnloadRenderTexture(boardLayer);
     }
-
-    // Shuffle the deck
-    std::random_device rd;
-    std::mt19937 g(rd());
-    std::shuffle(stock.begin(), stock.end(), g);
-
-    dealCards();
+    CardRenderer::unloadAllTextures();
 }
 
-void Solitaire::loadCards() {
-    const std::string suits[] = {"hearts", "diamonds", "clubs", "spades"};
-    const std::string values[] = {"ace", "2", "3", "4", "5", "6", "7", "8", "9", "10", "jack", "queen", "king"};
-
-    // Get the current working directory
-    std::string currentDir = GetWorkingDirectory();
-
-    for (const auto& suit : suits) {
-        for (const auto& value : values) {
-            // Try both possible paths
-            std::string imagePath = "assets/cards/" + value + "_of_" + suit + ".png";
-            if (!FileExists(imagePath.c_str())) {
-                // Try alternative path
-                imagePath = currentDir + "/assets/cards/" + value + "_of_" + suit + ".png";
-                if (!FileExists(imagePath.c_str())) {
-                    std::cerr << "Could not find card image for: " << value << " of " << suit << std::endl;
-                    continue;
-                }
-            }
-            stock.emplace_back(suit, value, imagePath);
-        }
-    }
-
-    // Shuffle the deck
-    std::random_device rd;
-    std::mt19937 g(rd());
-    std::shuffle(stock.begin(), stock.end(), g);
+void Solitaire::resetGame() {
+    // Pick a random deal number, the deal itself depends only on the number
+    newGame(static_cast<uint32_t>(dealPicker()));
 }
 
-void Solitaire::dealCards() {
-    // Deal cards to tableau piles
-    for (int i = 0; i < 7; i++) {
-        for (int j = i; j < 7; j++) {
-            if (!stock.empty()) {
-                Card card = stock.back();
-                stock.pop_back();
-                // The first card added to each pile (when j == i) should be face up
-                if (j == i) {
-                    card.flip();
-                }
-                // Add to back of vector (top of pile)
-                tableau[j].push_back(card);
-            }
-        }
+void Solitaire::resetWinnableGame() {
+    uint32_t dealNumber;
+    if (winnableDeals.pick(dealPicker, dealNumber)) {
+        newGame(dealNumber);
     }
 }
 
-std::vector<Card>* Solitaire::getPileAtPos(Vector2 pos) {
-    // Check tableau piles (moved down by MENU_HEIGHT)
-    for (int i = 0; i < 7; i++) {
-        float x = 50 + i * baseTableauSpacing;
-        float y = 130 + baseMenuHeight;  // Changed from 150 to 130
-        
-        // Check if click is within the pile's x-range
-        if (x <= pos.x && pos.x <= x + baseCardWidth) {
-            // If pile has cards, check each card's position
-            if (!tableau[i].empty()) {
-                float cardY = y;
-                for (size_t j = 0; j < tableau[i].size(); j++) {
-                    if (tableau[i][j].isFaceUp()) {
-                        tableau[i][j].setPosition(x, cardY);
-                        if (CheckCollisionPointRec(pos, tableau[i][j].getRect())) {
-                            return &tableau[i];
-                        }
-                    }
-                    cardY += baseCardSpacing;
-                }
-            } else {
-                // Empty tableau pile - check if click is in the empty space
-                Rectangle emptyRect = { x, y, static_cast<float>(baseCardWidth), static_cast<float>(baseCardHeight) };
-                if (CheckCollisionPointRec(pos, emptyRect)) {
-                    return &tableau[i];
-                }
-            }
-        }
-    }
-
-    // Check foundation piles (moved down by MENU_HEIGHT)
-    for (int i = 0; i < 4; i++) {
-        float x = 50 + i * baseTableauSpacing;
-        float y = 10 + baseMenuHeight;  // Add MENU_HEIGHT
-        
-        // Check if click is within the pile's x-range and y-range
-        if (x <= pos.x && pos.x <= x + baseCardWidth && y <= pos.y && pos.y <= y + baseCardHeight) {
-            if (!foundations[i].empty()) {
-                foundations[i].back().setPosition(x, y);
-                if (CheckCollisionPointRec(pos, foundations[i].back().getRect())) {
-                    return &foundations[i];
-                }
-            } else {
-                // Empty foundation pile
-                Rectangle emptyRect = { x, y, static_cast<float>(baseCardWidth), static_cast<float>(baseCardHeight) };
-                if (CheckCollisionPointRec(pos, emptyRect)) {
-                    return &foundations[i];
-                }
-            }
-        }
-    }
-
-    // Check stock pile
-    float stockX = 50;
-    float stockY = baseWindowHeight - baseCardHeight - 20;
-    Rectangle stockRect = { stockX, stockY, static_cast<float>(baseCardWidth), static_cast<float>(baseCardHeight) };
-    if (CheckCollisionPointRec(pos, stockRect)) {
-        return &stock;
-    }
-
-    // Check waste pile
-    float wasteX = stockX + baseTableauSpacing;
-    float wasteY = baseWindowHeight - baseCardHeight - 20;
-    if (!waste.empty()) {
-        waste.back().setPosition(wasteX, wasteY);
-        if (CheckCollisionPointRec(pos, waste.back().getRect())) {
-            return &waste;
-        }
-    } else {
-        // Empty waste pile
-        Rectangle emptyRect = { wasteX, wasteY, static_cast<float>(baseCardWidth), static_cast<float>(baseCardHeight) };
-        if (CheckCollisionPointRec(pos, emptyRect)) {
-            return &waste;
-        }
-    }
-
-    return nullptr;
+void Solitaire::newGame(uint32_t dealNumber) {
+    TRACE_SCOPE("newGame");
+    draggedSourcePile = noPile;
+    autoPlayPending = false;
+    autoCompleting = false;
+    gameWon = false;
+    klondike.newGame(dealNumber);
+    startJournal();
 }
 
-bool Solitaire::canMoveToTableau(const Card& card, const std::vector<Card>& targetPile) {
-    if (targetPile.empty()) {
-        // Only kings can be placed on empty tableau
-        return card.getValue() == 13;  // 13 represents king
-    }
-    
-    const Card& topCard = targetPile.back();
-    
-    // Check if colors are different and values are in sequence
-    bool colorsDifferent = (card.isRed() != topCard.isRed());
-    bool valuesInSequence = (card.getValue() == topCard.getValue() - 1);
-    
-    return colorsDifferent && valuesInSequence;
+void Solitaire::startJournal() {
+    TRACE_SCOPE("startJournal");
+#ifndef EMSCRIPTEN_BUILD
+    journal.open(journalFilePath, klondike);
+#endif
 }
 
-std::string Solitaire::getNextValue(const std::string& value) {
-    if (value == "king") return "queen";
-    if (value == "queen") return "jack";
-    if (value == "jack") return "10";
-    if (value == "10") return "9";
-    if (value == "9") return "8";
-    if (value == "8") return "7";
-    if (value == "7") return "6";
-    if (value == "6") return "5";
-    if (value == "5") return "4";
-    if (value == "4") return "3";
-    if (value == "3") return "2";
-    if (value == "2") return "ace";
-    return "";  // No next value for ace
+void Solitaire::loadCards() {
+    TRACE_SCOPE("loadCards");
+    // Cards are plain values now, only the card atlas needs loading
+    CardRenderer::loadAtlas();
 }
 
-bool Solitaire::canMoveToFoundation(const Card& card, const std::vector<Card>& targetPile) {
-    if (targetPile.empty()) {
-        // Only aces can start a foundation pile
-        return card.getValue() == 1; 
-    }
-    
-    const Card& topCard = targetPile.back();
-    // Cards must be of the same suit and in ascending order (A,2,3,...)
-    return (card.getSuit() == topCard.getSuit()) && (card.getValue() == topCard.getValue() + 1);
-}
-
-bool Solitaire::moveCards(std::vector<Card>& sourcePile, std::vector<Card>& targetPile, 
-                         int startIndex, int endIndex) {
-    if (startIndex < 0 || startIndex >= sourcePile.size()) {
-        return false;
-    }
-
-    if (endIndex == -1) {
-        endIndex = sourcePile.size() - 1;
-    }
-
-    // Move cards
-    for (int i = startIndex; i <= endIndex; i++) {
-        targetPile.push_back(sourcePile[i]);
-    }
-    sourcePile.erase(sourcePile.begin() + startIndex, sourcePile.begin() + endIndex + 1);
-
-    // Flip the new top card of the source pile if it exists
-    if (!sourcePile.empty() && !sourcePile.back().isFaceUp()) {
-        sourcePile.back().flip();
-    }
-
-    return true;
+int Solitaire::getPileAtPos(Vector2 pos) {
+    layout.update(klondike);
+    return layout.pileAt(pos.x, pos.y);
 }
 
 void Solitaire::handleMouseDown(Vector2 pos) {
@@ -289,119 +113,41 @@ void Solitaire::handleMouseDown(Vector2 pos) {
     pos.x = (pos.x - offsetX) / gameScale;
     pos.y = (pos.y - offsetY) / gameScale;
 
+    layout.update(klondike);
+
     // Check stock pile first
-    float stockX = 50;
-    float stockY = baseWindowHeight - baseCardHeight - 20;
-    Rectangle stockRect = { stockX, stockY, static_cast<float>(baseCardWidth), static_cast<float>(baseCardHeight) };
-    if (CheckCollisionPointRec(pos, stockRect)) {
-        if (stock.empty() && !waste.empty()) {
-            // Only restore waste cards if stock is empty and waste is not empty
-            while (!waste.empty()) {
-                Card card = waste.back();
-                waste.pop_back();
-                card.flip();  // Flip face down
-                stock.push_back(card);
-            }
-            lastDrawnCard = nullptr;  // Reset last drawn card when recycling waste
+    if (layout.slotContains(PileStock, pos.x, pos.y)) {
+        if (klondike.stock().empty()) {
+            // Only restores waste cards if stock is empty and waste is not empty
+            autoPlayPending = klondike.recycleWaste();
             return;  // Return here to prevent any further handling
         }
-        
+
         // Only deal a card if stock is not empty
-        if (!stock.empty()) {
-            Card card = stock.back();
-            stock.pop_back();
-            card.flip();  // Flip face up
-            waste.push_back(card);
-            lastDrawnCard = &waste.back();  // Track the last drawn card
+        if (klondike.drawFromStock()) {
             lastDealTime = GetTime();
+            autoPlayPending = true;
         }
 
         return;  // Return after handling stock pile
     }
 
-    // Find the card that was clicked (account for MENU_HEIGHT in foundation and tableau)
-    for (int i = 0; i < 7; i++) {
-        float x = 50 + i * baseTableauSpacing;
-        float y = 130 + baseMenuHeight;
-        
-        // Check if click is within the pile's x-range
-        if (x <= pos.x && pos.x <= x + baseCardWidth) {
-            // Find the actual card that was clicked by checking the y-position
-            float baseY = y;
-            float clickedY = pos.y;
-            
-            // Calculate which card was actually clicked based on y-position
-            int clickedIndex = (clickedY - baseY) / baseCardSpacing;
-            if (clickedIndex < 0) clickedIndex = 0;
-            if (clickedIndex >= tableau[i].size()) clickedIndex = tableau[i].size() - 1;
-            
-            // Only select if the card at this position is face up and we're actually clicking on its rectangle
-            if (tableau[i][clickedIndex].isFaceUp()) {
-                // Set the card's position to check for collision
-                tableau[i][clickedIndex].setPosition(x, baseY + clickedIndex * baseCardSpacing);
-                if (CheckCollisionPointRec(pos, tableau[i][clickedIndex].getRect())) {
-                    draggedCards.clear();
-                    for (int j = clickedIndex; j < tableau[i].size(); j++) {
-                        draggedCards.push_back(tableau[i][j]);
-                    }
-                    draggedStartIndex = clickedIndex;
-                    draggedSourcePile = &tableau[i];
-                    
-                    // Calculate offset from mouse position to card position
-                    dragOffset = {
-                        pos.x - x,
-                        pos.y - (baseY + clickedIndex * baseCardSpacing)
-                    };
-                    break;
-                }
-            }
-        }
-        if (!draggedCards.empty()) break;
-    }
-
-    // Check foundation piles if no card was found in tableau
-    if (draggedCards.empty()) {
-        for (int i = 0; i < 4; i++) {
-            float x = 50 + i * baseTableauSpacing;
-            float y = 10 + baseMenuHeight;
-            
-            if (!foundations[i].empty()) {
-                foundations[i].back().setPosition(x, y);
-                if (CheckCollisionPointRec(pos, foundations[i].back().getRect())) {
-                    draggedCards.clear();
-                    draggedCards.push_back(foundations[i].back());
-                    draggedStartIndex = foundations[i].size() - 1;
-                    draggedSourcePile = &foundations[i];
-                    
-                    // Calculate offset from mouse position to card position
-                    dragOffset = {
-                        pos.x - x,
-                        pos.y - y
-                    };
-                    break;
-                }
-            }
-        }
+    // Pick up the face-up tableau card under the mouse and everything on it,
+    // or the top foundation or waste card
+    int pile, index;
+    if (!layout.cardAt(pos.x, pos.y, pile, index)) {
+        return;
     }
+    draggedStartIndex = index;
+    draggedSourcePile = pile;
+    draggedVersion = klondike.getStateVersion();
 
-    // Check waste pile if no card was found in tableau or foundation
-    if (draggedCards.empty() && !waste.empty()) {
-        float wasteX = stockX + baseTableauSpacing;
-        float wasteY = baseWindowHeight - baseCardHeight - 20;
-        waste.back().setPosition(wasteX, wasteY);
-        if (CheckCollisionPointRec(pos, waste.back().getRect())) {
-            draggedCards.clear();
-            draggedCards.push_back(waste.back());
-            draggedStartIndex = 0;
-            draggedSourcePile = &waste;
-            
-            // Calculate offset from mouse position to card position
-            dragOffset = {
-                pos.x - wasteX,
-                pos.y - wasteY
-            };
-        }
-    }
+    // Calculate offset from mouse position to card position
+    int entry = layout.firstEntry(pile) + (isTableauPile(pile) ? index : layout.entryCount(pile) - 1);
+    dragOffset = {
+        pos.x - layout.entryX(entry),
+        pos.y - layout.entryY(entry)
+    };
 }
 
 void Solitaire::handleMouseUp(Vector2 pos) {
@@ -414,130 +160,25 @@ void Solitaire::handleMouseUp(Vector2 pos) {
     pos.y = (pos.y - offsetY) / gameScale;
 
     // If we're not dragging any cards, there's nothing to do
-    if (draggedCards.empty()) return;
-
-    // Make sure we have a valid source pile
-    if (!draggedSourcePile) {
-        draggedCards.clear();
-        return;
-    }
+    if (!isDragging()) return;
 
-    std::vector<Card>* targetPile = getPileAtPos(pos);
-    if (!targetPile) {
-        // Return cards to original position
-        returnDraggedCards();
-        draggedCards.clear();
-        draggedSourcePile = nullptr;
-        return;
-    }
-
-    if (targetPile == draggedSourcePile) {
-        // Dropping cards back onto their original pile, just clear the dragged state
-        returnDraggedCards();
-        draggedCards.clear();
-        draggedSourcePile = nullptr;
-        return;
-    }
-
-    // Check if target pile is the waste pile - never allow dropping cards on the waste pile
-    if (targetPile == &waste) {
-        returnDraggedCards();
-        draggedCards.clear();
-        draggedSourcePile = nullptr;
-        return;
-    }
-
-    // Check if target pile is the stock pile - never allow dropping cards on the stock pile
-    if (targetPile == &stock) {
-        returnDraggedCards();
-        draggedCards.clear();
-        draggedSourcePile = nullptr;
-        return;
-    }
-
-    // Check if target pile is a foundation pile
-    bool isFoundationPile = false;
-    for (auto& foundation : foundations) {
-        if (targetPile == &foundation) {
-            isFoundationPile = true;
-            break;
-        }
-    }
-
-    // Handle foundation pile placement - only single cards, must follow suit and sequence
-    if (isFoundationPile) {
-        // Only single cards can be moved to foundation
-        if (draggedCards.size() == 1 && canMoveToFoundation(draggedCards[0], *targetPile)) {
-            moveCards(*draggedSourcePile, *targetPile, draggedSourcePile->size() - 1);
-        } else {
-            // Invalid move to foundation
-            returnDraggedCards();
-        }
-    }
-    // Handle tableau pile placement
-    else {
-        // Check if we can move to tableau
-        bool canMove = canMoveToTableau(draggedCards[0], *targetPile);
-
-        if (canMove) {
-            // If dragging from waste pile or foundation pile, only move the top card
-            if (draggedSourcePile == &waste || 
-                draggedSourcePile == &foundations[0] || draggedSourcePile == &foundations[1] || 
-                draggedSourcePile == &foundations[2] || draggedSourcePile == &foundations[3]) {
-                moveCards(*draggedSourcePile, *targetPile, draggedSourcePile->size() - 1);
-            } else {
-                moveCards(*draggedSourcePile, *targetPile, draggedStartIndex);
-            }
-        } else {
-            // Invalid move to tableau
-            returnDraggedCards();
-        }
+    // The rules engine rejects drops on the source pile, the waste and the
+    // stock, so an invalid target just sends the cards back
+    int targetPile = getPileAtPos(pos);
+    if (targetPile != noPile && klondike.tryMove(draggedSourcePile, draggedStartIndex, targetPile)) {
+        autoPlayPending = true;
     }
 
     // Clean up the dragged state
-    draggedCards.clear();
-    draggedSourcePile = nullptr;
+    returnDraggedCards();
 }
 
 // Add this helper method to avoid code duplication
 void Solitaire::returnDraggedCards() {
-    if (!draggedSourcePile || draggedCards.empty()) {
-        return; // Safety check
-    }
-
-    if (draggedSourcePile == &waste) {
-        float stockX = 50;
-        float wasteX = stockX + baseTableauSpacing;
-        float wasteY = baseWindowHeight - baseCardHeight - 20;
-        for (size_t i = 0; i < draggedCards.size(); i++) {
-            draggedCards[i].setPosition(wasteX, wasteY);
-        }
-    } else if (draggedSourcePile == &foundations[0] || draggedSourcePile == &foundations[1] || 
-              draggedSourcePile == &foundations[2] || draggedSourcePile == &foundations[3]) {
-        // Find the original foundation pile
-        for (int i = 0; i < 4; i++) {
-            if (&foundations[i] == draggedSourcePile) {
-                float x = 50 + i * baseTableauSpacing;
-                float y = 10 + baseMenuHeight;
-                for (size_t j = 0; j < draggedCards.size(); j++) {
-                    draggedCards[j].setPosition(x, y);
-                }
-                break;
-            }
-        }
-    } else {
-        // Find the original tableau pile
-        for (int i = 0; i < 7; i++) {
-            if (&tableau[i] == draggedSourcePile) {
-                float x = 50 + i * baseTableauSpacing;
-                float y = 130 + baseMenuHeight;
-                for (size_t j = 0; j < draggedCards.size(); j++) {
-                    draggedCards[j].setPosition(x, y + (draggedStartIndex + j) * baseCardSpacing);
-                }
-                break;
-            }
-        }
-    }
+    // The dragged cards never left the source pile, so ending the view puts
+    // them back where they were. Their screen positions are derived from the
+    // piles every frame.
+    draggedSourcePile = noPile;
 }
 
 void Solitaire::handleDoubleClick(Vector2 pos) {
@@ -549,109 +190,45 @@ void Solitaire::handleDoubleClick(Vector2 pos) {
     pos.x = (pos.x - offsetX) / gameScale;
     pos.y = (pos.y - offsetY) / gameScale;
 
-    std::vector<Card>* pile = getPileAtPos(pos);
-    if (!pile || pile->empty()) return;
+    int pile = getPileAtPos(pos);
+    if (pile == noPile || klondike.pile(pile).empty()) return;
 
     // Don't allow double-clicking on waste pile if the card was just dealt
-    if (pile == &waste && GetTime() - lastDealTime < 0.5) {  // 500ms delay
+    if (pile == PileWaste && GetTime() - lastDealTime < 0.5) {  // 500ms delay
         return;
     }
 
-    Card& card = pile->back();
+    Card card = klondike.pile(pile).back();
     // Only allow double-clicking on face-up cards
     if (!card.isFaceUp()) return;
 
-    std::vector<Card>* foundationPile = findValidFoundationPile(card);
-    if (foundationPile) {
-        moveCards(*pile, *foundationPile, pile->size() - 1);
-    }
-}
-
-std::vector<Card>* Solitaire::findValidFoundationPile(const Card& card) {
-    for (auto& foundation : foundations) {
-        if (canMoveToFoundation(card, foundation)) {
-            return &foundation;
-        }
+    int foundationPile = klondike.findValidFoundationPile(card);
+    if (foundationPile != noPile && klondike.tryMove(pile, klondike.pile(pile).size() - 1, foundationPile)) {
+        autoPlayPending = true;
     }
-    return nullptr;
 }
 
-bool Solitaire::checkWin() {
-    for (const auto& foundation : foundations) {
-        if (foundation.empty() || foundation.back().getValue() != 13) {
-            return false;
-        }
-    }
-    return true;
+bool Solitaire::saveGame() {
+    TRACE_SCOPE("saveGame");
+    return SaveFormat::write(saveFilePath, klondike);
 }
 
-bool Solitaire::saveGame() {
-#ifndef EMSCRIPTEN_BUILD
-    std::ofstream file("solitaire_save.txt");
-    if (!file.is_open()) {
-        return false;
-    }
-    
-    try {
-        json gameState;
-        
-        // Save tableau piles
-        for (const auto& pile : tableau) {
-            json pileJson;
-            for (const auto& card : pile) {
-                json cardJson;
-                cardJson["suit"] = card.getSuit();
-                cardJson["value"] = card.getValue();
-                cardJson["faceUp"] = card.isFaceUp();
-                pileJson.push_back(cardJson);
-            }
-            gameState["tableau"].push_back(pileJson);
-        }
-        
-        // Save foundation piles
-        for (const auto& pile : foundations) {
-            json pileJson;
-            for (const auto& card : pile) {
-                json cardJson;
-                cardJson["suit"] = card.getSuit();
-                cardJson["value"] = card.getValue();
-                cardJson["faceUp"] = card.isFaceUp();
-                pileJson.push_back(cardJson);
-            }
-            gameState["foundations"].push_back(pileJson);
-        }
-        
-        // Save stock pile
-        for (const auto& card : stock) {
-            json cardJson;
-            cardJson["suit"] = card.getSuit();
-            cardJson["value"] = card.getValue();
-            cardJson["faceUp"] = card.isFaceUp();
-            gameState["stock"].push_back(cardJson);
-        }
-        
-        // Save waste pile
-        for (const auto& card : waste) {
-            json cardJson;
-            cardJson["suit"] = card.getSuit();
-            cardJson["value"] = card.getValue();
-            cardJson["faceUp"] = card.isFaceUp();
-            gameState["waste"].push_back(cardJson);
-        }
-        
-        file << gameState.dump(4);
-        file.close();
-        return true;
-    } catch (const std::exception& e) {
+bool Solitaire::loadGame() {
+    TRACE_SCOPE("loadGame");
+    if (!SaveFormat::read(saveFilePath, klondike) && !loadLegacyGame()) {
         return false;
     }
-#endif
-    return false;  // Return false if not compiled with PLATFORM_DESKTOP
+    draggedSourcePile = noPile;
+    autoPlayPending = false;
+    autoCompleting = false;
+    gameWon = klondike.checkWin();
+    startJournal();
+    return true;
 }
 
-bool Solitaire::loadGame() {
+bool Solitaire::loadLegacyGame() {
 #ifndef EMSCRIPTEN_BUILD
-    std::ifstream file("solitaire_save.txt");
+    std::ifstream file(legacySaveFilePath);
     if (!file.is_open()) {
         return false;
     }
@@ -661,62 +238,51 @@ bool Solitaire::loadGame() {
         file >> gameState;
         file.close();
         
-        // Clear current game state
-        tableau.clear();
-        foundations.clear();
-        stock.clear();
-        waste.clear();
-        draggedCards.clear();
-        draggedSourcePile = nullptr;
-        gameWon = false;
-        
-        // Initialize tableau and foundations
-        tableau.resize(7);
-        foundations.resize(4);
+        // Read into a scratch game, a file that fails half way leaves the
+        // current one as it was
+        Klondike loaded;
+        if (gameState.contains("deal")) {
+            loaded.setDealNumber(gameState["deal"].get<uint32_t>());
+        }
         
         // Load tableau piles
-        for (size_t i = 0; i < gameState["tableau"].size(); i++) {
+        for (size_t i = 0; i < gameState["tableau"].size() && i < tableauPileCount; i++) {
             for (const auto& cardData : gameState["tableau"][i]) {
                 std::string suit = cardData["suit"];
                 int value = cardData["value"];
                 bool faceUp = cardData["faceUp"];
-                
-                // Convert value back to string
-                std::string valueStr;
-                if (value == 1) valueStr = "ace";
-                else if (value == 11) valueStr = "jack";
-                else if (value == 12) valueStr = "queen";
-                else if (value == 13) valueStr = "king";
-                else valueStr = std::to_string(value);
-                
+                int suitIndex = Card::suitFromName(suit.c_str());
+                if (suitIndex < 0 || value < 1 || value > cardRankCount) {
+                    return false;
+                }
+
                 // Create card
-                std::string imagePath = "assets/cards/" + valueStr + "_of_" + suit + ".png";
-                Card card(suit, valueStr, imagePath);
-                if (faceUp) card.flip();
-                tableau[i].push_back(card);
+                Card card(static_cast<CardSuit>(suitIndex), value, faceUp);
+                // Piles hold at most one deck, a longer one means a corrupt file
+                if (loaded.pile(PileTableau0 + i).full()) {
+                    return false;
+                }
+                loaded.pile(PileTableau0 + i).push_back(card);
             }
         }
         
         // Load foundation piles
-        for (size_t i = 0; i < gameState["foundations"].size(); i++) {
+        for (size_t i = 0; i < gameState["foundations"].size() && i < foundationPileCount; i++) {
             for (const auto& cardData : gameState["foundations"][i]) {
                 std::string suit = cardData["suit"];
                 int value = cardData["value"];
                 bool faceUp = cardData["faceUp"];
-                
-                // Convert value back to string
-                std::string valueStr;
-                if (value == 1) valueStr = "ace";
-                else if (value == 11) valueStr = "jack";
-                else if (value == 12) valueStr = "queen";
-                else if (value == 13) valueStr = "king";
-                else valueStr = std::to_string(value);
-                
+                int suitIndex = Card::suitFromName(suit.c_str());
+                if (suitIndex < 0 || value < 1 || value > cardRankCount) {
+                    return false;
+                }
+
                 // Create card
-                std::string imagePath = "assets/cards/" + valueStr + "_of_" + suit + ".png";
-                Card card(suit, valueStr, imagePath);
-                if (faceUp) card.flip();
-                foundations[i].push_back(card);
+                Card card(static_cast<CardSuit>(suitIndex), value, faceUp);
+                if (loaded.pile(PileFoundation0 + i).full()) {
+                    return false;
+                }
+                loaded.pile(PileFoundation0 + i).push_back(card);
             }
         }
         
@@ -725,20 +291,17 @@ bool Solitaire::loadGame() {
             std::string suit = cardData["suit"];
             int value = cardData["value"];
             bool faceUp = cardData["faceUp"];
-            
-            // Convert value back to string
-            std::string valueStr;
-            if (value == 1) valueStr = "ace";
-            else if (value == 11) valueStr = "jack";
-            else if (value == 12) valueStr = "queen";
-            else if (value == 13) valueStr = "king";
-            else valueStr = std::to_string(value);
-            
+            int suitIndex = Card::suitFromName(suit.c_str());
+            if (suitIndex < 0 || value < 1 || value > cardRankCount) {
+                return false;
+            }
+
             // Create card
-            std::string imagePath = "assets/cards/" + valueStr + "_of_" + suit + ".png";
-            Card card(suit, valueStr, imagePath);
-            if (faceUp) card.flip();
-            stock.push_back(card);
+            Card card(static_cast<CardSuit>(suitIndex), value, faceUp);
+            if (loaded.pile(PileStock).full()) {
+                return false;
+            }
+            loaded.pile(PileStock).push_back(card);
         }
         
         // Load waste pile
@@ -746,23 +309,24 @@ bool Solitaire::loadGame() {
             std::string suit = cardData["suit"];
             int value = cardData["value"];
             bool faceUp = cardData["faceUp"];
-            
-            // Convert value back to string
-            std::string valueStr;
-            if (value == 1) valueStr = "ace";
-            else if (value == 11) valueStr = "jack";
-            else if (value == 12) valueStr = "queen";
-            else if (value == 13) valueStr = "king";
-            else valueStr = std::to_string(value);
-            
+            int suitIndex = Card::suitFromName(suit.c_str());
+            if (suitIndex < 0 || value < 1 || value > cardRankCount) {
+                return false;
+            }
+
             // Create card
-            std::string imagePath = "assets/cards/" + valueStr + "_of_" + suit + ".png";
-            Card card(suit, valueStr, imagePath);
-            if (faceUp) card.flip();
-            waste.push_back(card);
+            Card card(static_cast<CardSuit>(suitIndex), value, faceUp);
+            if (loaded.pile(PileWaste).full()) {
+                return false;
+            }
+            loaded.pile(PileWaste).push_back(card);
         }
-        
-        return true;
+
+        // Committed through the binary format, which also refuses a board
+        // that is not exactly one deck
+        SaveImage image;
+        SaveFormat::encode(loaded, image);
+        return SaveFormat::decode(image, klondike);
     } catch (const std::exception& e) {
         return false;
     }
@@ -798,19 +362,25 @@ void Solitaire::handleMenuClick(Vector2 pos) {
     }
     // Check if clicking on File menu items
     else if (menuOpen && pos.y >= baseMenuItemHeight && pos.y < baseMenuItemHeight + baseMenuDropdownHeight) {
-        if (pos.x >= baseMenuFileX && pos.x < baseMenuFileX + baseMenuFileWidth) {
+        if (pos.x >= baseMenuFileX && pos.x < baseMenuFileX + baseMenuFileDropdownWidth) {
             int itemIndex = (pos.y - baseMenuItemHeight) / baseMenuItemHeight;
             switch (itemIndex) {
                 case 0: // New Game
                     resetGame();
                     break;
-                case 1: // Save
+                case 1: // New Winnable Game
+                    resetWinnableGame();
+                    break;
+                case 2: // Hint
+                    hints.start(klondike);
+                    break;
+                case 3: // Save
                     saveGame();
                     break;
-                case 2: // Load
+                case 4: // Load
                     loadGame();
                     break;
-                case 3: // Exit
+                case 5: // Exit
                     shouldClose = true;
                     break;
             }
@@ -847,17 +417,9 @@ void Solitaire::handleRightClick(Vector2 pos) {
     pos.y = (pos.y - offsetY) / gameScale;
 
     // Check if clicking on stock pile area
-    float stockX = 50;
-    float stockY = baseWindowHeight - baseCardHeight - 20;
-    Rectangle stockRect = { stockX, stockY, static_cast<float>(baseCardWidth), static_cast<float>(baseCardHeight) };
-    
-    if (CheckCollisionPointRec(pos, stockRect) && lastDrawnCard != nullptr && !waste.empty() && lastDrawnCard == &waste.back()) {
+    if (layout.slotContains(PileStock, pos.x, pos.y)) {
         // Move the last drawn card back to stock
-        Card card = waste.back();
-        waste.pop_back();
-        card.flip();  // Flip face down
-        stock.push_back(card);
-        lastDrawnCard = nullptr;  // Reset last drawn card after undo
+        klondike.undoDraw();
     }
 }
 
@@ -868,6 +430,40 @@ void Solitaire::update() {
     if (frameCount % 60 == 0) {  // Log every second (assuming 60 FPS)
     }
 
+    // Finish a background texture load a few cells per frame
+    CardRenderer::update();
+
+    // Input can change the picture (menus, dragging, the About dialog) even
+    // when the game state does not. Plain mouse motion only matters while
+    // dragging, or with the overlay open so its counters can be refreshed.
+    Vector2 mouseDelta = GetMouseDelta();
+    bool mouseMoved = mouseDelta.x != 0 || mouseDelta.y != 0;
+    if (GetKeyPressed() != 0 || IsMouseButtonPressed(MOUSE_LEFT_BUTTON) || IsMouseButtonReleased(MOUSE_LEFT_BUTTON) ||
+        IsMouseButtonPressed(MOUSE_RIGHT_BUTTON) || (mouseMoved && (isDragging() || showRenderStats))) {
+        redrawNeeded = true;
+    }
+
+    if (IsKeyPressed(KEY_F2)) {
+        showRenderStats = !showRenderStats;
+    }
+
+    // Ctrl+Z undoes the last move, Ctrl+Y or Ctrl+Shift+Z redoes it
+    bool control = IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_RIGHT_CONTROL);
+    bool shift = IsKeyDown(KEY_LEFT_SHIFT) || IsKeyDown(KEY_RIGHT_SHIFT);
+    if (control && !isDragging()) {
+        bool changed = false;
+        if (IsKeyPressed(KEY_Z) && !shift) {
+            changed = klondike.undo();
+        } else if (IsKeyPressed(KEY_Y) || (IsKeyPressed(KEY_Z) && shift)) {
+            changed = klondike.redo();
+        }
+        if (changed) {
+            autoPlayPending = false;  // Otherwise an undone safe move would be played again
+            autoCompleting = false;
+            gameWon = klondike.checkWin();
+        }
+    }
+
     if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
         Vector2 pos = GetMousePosition();
         
@@ -900,97 +496,192 @@ void Solitaire::update() {
         handleRightClick(pos);
     }
 
-    if (checkWin()) {
+    // Safe foundation moves follow the player's move one per frame, so they
+    // can be seen. Once only plain play is left, auto-complete takes over.
+    if (autoPlayPending && !isDragging()) {
+        autoPlayPending = AutoPlay::playStep(klondike, autoCompleting);
+    }
+
+    if (klondike.checkWin()) {
         gameWon = true;
     }
-}
 
-void Solitaire::draw() {
-    static int drawCount = 0;
-    drawCount++;
+    // Any change to the game makes the hint stale, the search stops at once
+    if (hints.getStateVersion() != klondike.getStateVersion() && (hints.best().valid || hints.isSearching())) {
+        hints.cancel();
+    }
+    if (hints.best().revision != shownHintRevision) {
+        redrawNeeded = true;
+    }
 
-    ClearBackground(GREEN);
+    // The win chance is estimated again once the position settles, the old
+    // number stays up until the new one is in
+    if (winEstimator.getStateVersion() != klondike.getStateVersion() && !autoPlayPending && !isDragging()) {
+        winEstimator.start(klondike);
+    }
+    if (winEstimator.update()) {
+        redrawNeeded = true;
+    }
 
-    // Draw foundation piles (moved down by MENU_HEIGHT)
-    for (int i = 0; i < 4; i++) {
-        float x = 50 + i * baseTableauSpacing;
-        float y = 10 + baseMenuHeight;  // Add MENU_HEIGHT
-        if (!foundations[i].empty()) {
-            // If this foundation pile is the source of the dragged card, show the card underneath
-            if (draggedSourcePile == &foundations[i] && foundations[i].size() > 1) {
-                foundations[i][foundations[i].size() - 2].setPosition(x, y);
-                foundations[i][foundations[i].size() - 2].draw();
-            } else if (draggedSourcePile != &foundations[i]) {
-                // Otherwise show the top card if it's not being dragged
-                foundations[i].back().setPosition(x, y);
-                foundations[i].back().draw();
-            }
-        } else {
-            // Draw empty foundation slot
-            DrawRectangle(x, y, baseCardWidth, baseCardHeight, WHITE);
-            DrawRectangleLines(x, y, baseCardWidth, baseCardHeight, BLACK);
-        }
+    // A double or right click can move cards while a drag is held; the view
+    // would then show whatever took their place, so the drag ends instead
+    if (isDragging() && klondike.getStateVersion() != draggedVersion) {
+        returnDraggedCards();
     }
 
-    // Draw tableau piles (moved down by MENU_HEIGHT)
-    for (int i = 0; i < 7; i++) {
-        float x = 50 + i * baseTableauSpacing;
-        float y = 130 + baseMenuHeight;
-         
-        for (size_t j = 0; j < tableau[i].size(); j++) {
-            // Skip drawing cards that are being dragged
-            if (draggedSourcePile == &tableau[i] && j >= draggedStartIndex) {
+    // A drag just started: render the rest of the board once, draw() then
+    // only adds the dragged cards on top. Not while the cards are loading,
+    // the layer would miss the ones still to come.
+    if (isDragging() && !isBoardLayerCurrent() && CardRenderer::areTexturesLoaded()) {
+        cacheBoardLayer();
+    }
+
+    // Cards keep appearing until the first atlas is complete
+    if (klondike.getStateVersion() != drawnVersion || !CardRenderer::areTexturesLoaded()) {
+        redrawNeeded = true;
+    }
+}
+
+void Solitaire::drawBoard() {
+    layout.update(klondike);
+    ClearBackground(GREEN);
+
+    // Draw empty foundation slots first, so that every card below is drawn
+    // from the atlas without a texture switch in between
+    for (int i = 0; i < foundationPileCount; i++) {
+        int pile = PileFoundation0 + i;
+        if (layout.entryCount(pile) == 0) {
+            DrawRectangle(layout.slotX(pile), layout.slotY(pile), baseCardWidth, baseCardHeight, WHITE);
+            DrawRectangleLines(layout.slotX(pile), layout.slotY(pile), baseCardWidth, baseCardHeight, BLACK);
+        }
+    }
+
+    // Draw the visible cards of every pile in PileId order, so the stock and
+    // waste go over a long tableau column. Each pile's entries are bottom
+    // first, except the stock, which the layout orders the way its stack is
+    // drawn.
+    for (int pile = 0; pile < PileCount; pile++) {
+        int first = layout.firstEntry(pile);
+        int end = first + layout.entryCount(pile);
+        if (pile == draggedSourcePile) {
+            if (isTableauPile(pile)) {
+                // Skip drawing cards that are being dragged
+                end = first + draggedStartIndex;
+            } else if (isFoundationPile(pile)) {
+                // Show the card underneath the dragged foundation card
+                first = std::max(first, end - 2);
+                end--;
+            } else {
                 continue;
             }
-            tableau[i][j].setPosition(x, y + j * baseCardSpacing);
-            tableau[i][j].draw();
+        } else if (isFoundationPile(pile) || pile == PileWaste) {
+            first = std::max(first, end - 1);  // Only the top card shows
+        }
+        for (int entry = first; entry < end; entry++) {
+            CardRenderer::draw(layout.entryCard(entry), layout.entryX(entry), layout.entryY(entry));
         }
     }
 
-    // Draw stock pile
-    float stockX = 50;
-    float stockY = baseWindowHeight - baseCardHeight - 20;
-    if (!stock.empty()) {
-        // Skip drawing the stock card if it's being dragged
-        if (draggedSourcePile != &stock) {
-            // Draw a stack of cards for the stock pile
-            int numCards = stock.size();
-            int maxVisibleCards = 5;  // Maximum number of cards to show in the stack
-            int cardsToShow = std::min(numCards, maxVisibleCards);
-            
-            for (int i = 0; i < cardsToShow; i++) {
-                // Calculate offset for each card in the stack
-                float offsetX = i * 2;  // Small horizontal offset
-                float offsetY = i * 2;  // Small vertical offset
-                
-                // Get the card from the end of the stock pile
-                Card& card = stock[stock.size() - 1 - i];
-                card.setPosition(stockX + offsetX, stockY + offsetY);
-                card.draw();
-            }
-            
-            // Always show the total number of cards
-            int fontSize = static_cast<int>(20);
-            DrawText(TextFormat("%d", numCards), 
-                    stockX + baseCardWidth - 55, 
-                    stockY + baseCardHeight - 20, 
-                    fontSize, BLACK);
+    // Always show the total number of stock cards, after the last board card
+    // so the text does not split the card batch
+    const CardPile& stock = klondike.stock();
+    if (!stock.empty() && draggedSourcePile != PileStock) {
+        int fontSize = static_cast<int>(20);
+        DrawText(TextFormat("%d", static_cast<int>(stock.size())),
+                layout.slotX(PileStock) + baseCardWidth - 55,
+                layout.slotY(PileStock) + baseCardHeight - 20,
+                fontSize, BLACK);
+    }
+}
+
+void Solitaire::cacheBoardLayer() {
+    // Rendered at the atlas scale like the game target, so the layer is
+    // copied to it texel for texel
+    float scale = CardRenderer::getAtlasScale();
+    int width = static_cast<int>(baseWindowWidth * scale);
+    int height = static_cast<int>(baseWindowHeight * scale);
+    if (boardLayer.texture.width != width || boardLayer.texture.height != height) {
+        if (boardLayer.id != 0) {
+            UnloadRenderTexture(boardLayer);
         }
+        boardLayer = LoadRenderTexture(width, height);
+    }
+    if (boardLayer.id == 0) {
+        return;
+    }
+
+    BeginTextureMode(boardLayer);
+    Camera2D camera = { { 0.0f, 0.0f }, { 0.0f, 0.0f }, 0.0f, scale };
+    BeginMode2D(camera);
+    drawBoard();
+    EndMode2D();
+    EndTextureMode();
+    boardLayerVersion = klondike.getStateVersion();
+    boardLayerSourcePile = draggedSourcePile;
+    boardLayerStartIndex = draggedStartIndex;
+}
+
+bool Solitaire::isBoardLayerCurrent() const {
+    // The layer is dropped when the drag ends, the state changes under it or
+    // an atlas for another scale is swapped in
+    float scale = CardRenderer::getAtlasScale();
+    return isDragging() && boardLayer.id != 0 && boardLayerVersion == klondike.getStateVersion() &&
+           boardLayerSourcePile == draggedSourcePile && boardLayerStartIndex == draggedStartIndex &&
+           boardLayer.texture.width == static_cast<int>(baseWindowWidth * scale) &&
+           boardLayer.texture.height == static_cast<int>(baseWindowHeight * scale);
+}
+
+void Solitaire::drawHint(const Hint& hint) {
+    const float thickness = 3.0f;
+    Color color = hint.winning ? GOLD : SKYBLUE;  // Gold once the solver has proven the move wins
+    layout.update(klondike);
+
+    // The stock for a draw or a recycle, otherwise the moving cards
+    int source = hint.move.type == MoveTypeCards ? static_cast<int>(hint.move.source) : static_cast<int>(PileStock);
+    Rectangle from = { layout.slotX(source), layout.slotY(source), baseCardWidth, baseCardHeight };
+    if (isTableauPile(source) && layout.entryCount(source) > 0) {
+        int first = layout.firstEntry(source);
+        int last = first + layout.entryCount(source) - 1;
+        from.y = layout.entryY(first + hint.move.startIndex);
+        from.height = layout.entryY(last) + baseCardHeight - from.y;
     }
+    DrawRectangleLinesEx(from, thickness, color);
 
-    // Draw waste pile
-    float wasteX = stockX + baseTableauSpacing;
-    float wasteY = baseWindowHeight - baseCardHeight - 20;
-    if (!waste.empty()) {
-        // Skip drawing the waste card if it's being dragged
-        if (draggedSourcePile != &waste) {
-            waste.back().setPosition(wasteX, wasteY);
-            waste.back().draw();
+    if (hint.move.type == MoveTypeCards) {
+        int target = hint.move.target;
+        Rectangle to = { layout.slotX(target), layout.slotY(target), baseCardWidth, baseCardHeight };
+        if (isTableauPile(target) && layout.entryCount(target) > 0) {
+            to.y = layout.entryY(layout.firstEntry(target) + layout.entryCount(target) - 1);
         }
+        DrawRectangleLinesEx(to, thickness, color);
+    }
+}
+
+void Solitaire::draw() {
+    static int drawCount = 0;
+    drawCount++;
+    redrawNeeded = false;
+    drawnVersion = klondike.getStateVersion();
+    CardRenderer::beginFrame();
+
+    if (isBoardLayerCurrent()) {
+        // Only the dragged stack moves, the rest of the board is the layer
+        // rendered when the drag started
+        Rectangle source = { 0.0f, 0.0f, static_cast<float>(boardLayer.texture.width), static_cast<float>(-boardLayer.texture.height) };
+        Rectangle dest = { 0.0f, 0.0f, static_cast<float>(baseWindowWidth), static_cast<float>(baseWindowHeight) };
+        DrawTexturePro(boardLayer.texture, source, dest, { 0, 0 }, 0.0f, WHITE);
+    } else {
+        drawBoard();
+    }
+
+    Hint hint = hints.best();
+    shownHintRevision = hint.revision;
+    if (hint.valid) {
+        drawHint(hint);
     }
 
     // Draw dragged cards
-    if (!draggedCards.empty()) {
+    if (isDragging()) {
         Vector2 mousePos = GetMousePosition();
         // Calculate the offset to center the game in the window (same as in main.cpp)
         float offsetX = (GetScreenWidth() - (baseWindowWidth * gameScale)) * 0.5f;
@@ -1000,13 +691,13 @@ void Solitaire::draw() {
         mousePos.x = (mousePos.x - offsetX) / gameScale;
         mousePos.y = (mousePos.y - offsetY) / gameScale;
 
-        for (size_t i = 0; i < draggedCards.size(); i++) {
+        const CardPile& cards = klondike.pile(draggedSourcePile);
+        for (size_t i = draggedStartIndex; i < cards.size(); i++) {
             // Apply the drag offset to maintain the relative position
-            draggedCards[i].setPosition(
+            CardRenderer::draw(cards[i],
                 mousePos.x - dragOffset.x,
-                mousePos.y - dragOffset.y + i * baseCardSpacing
+                mousePos.y - dragOffset.y + (i - draggedStartIndex) * baseCardSpacing
             );
-            draggedCards[i].draw();
         }
     }
 
@@ -1016,15 +707,43 @@ void Solitaire::draw() {
     int fontSize = static_cast<int>(20);
     DrawText("File", baseMenuFileX + baseMenuTextPadding, baseMenuTextPadding, fontSize, WHITE);
     DrawText("Help", baseMenuHelpX + baseMenuTextPadding, baseMenuTextPadding, fontSize, WHITE);
+    // The status texts share the bar to the right of Help. The hint sits on
+    // the left, the deal number on the right, and whatever does not fit
+    // between them is dropped: first the win estimate, then ", winnable"
+    int leftEnd = baseMenuHelpX + baseMenuHelpWidth;
+    if (hint.valid) {
+        const char* hintText = hint.winning ? "Hint: winning line" : hint.finished ? "Hint: no winning line found" : "Hint: searching...";
+        DrawText(hintText, leftEnd + baseMenuTextPadding, baseMenuTextPadding, fontSize, hint.winning ? GOLD : SKYBLUE);
+        leftEnd += baseMenuTextPadding + MeasureText(hintText, fontSize);
+    }
+    const char* dealText = winnableDeals.find(klondike.getDealNumber()) ? TextFormat("Game #%u, winnable", klondike.getDealNumber())
+                                                                        : TextFormat("Game #%u", klondike.getDealNumber());
+    int dealTextX = baseWindowWidth - MeasureText(dealText, fontSize) - baseMenuTextPadding * 2;
+    if (dealTextX < leftEnd + baseMenuTextPadding * 3) {
+        dealText = TextFormat("Game #%u", klondike.getDealNumber());
+        dealTextX = baseWindowWidth - MeasureText(dealText, fontSize) - baseMenuTextPadding * 2;
+    }
+    DrawText(dealText, dealTextX, baseMenuTextPadding, fontSize, LIGHTGRAY);
+    if (winEstimator.hasEstimate() && !gameWon) {
+        const char* winText = TextFormat("Win ~%d%%", static_cast<int>(winEstimator.getEstimate().probability() * 100.0f + 0.5f));
+        int winTextX = dealTextX - MeasureText(winText, fontSize) - baseMenuTextPadding * 3;
+        if (winTextX >= leftEnd + baseMenuTextPadding * 3) {
+            DrawText(winText, winTextX, baseMenuTextPadding, fontSize, LIGHTGRAY);
+        }
+    }
     
     // Draw menu items when File is clicked
     if (menuOpen) {
-        DrawRectangle(baseMenuFileX, baseMenuHeight, baseMenuFileWidth, baseMenuDropdownHeight, DARKGRAY);
+        DrawRectangle(baseMenuFileX, baseMenuHeight, baseMenuFileDropdownWidth, baseMenuDropdownHeight, DARKGRAY);
         DrawText("New Game", baseMenuFileX + baseMenuTextPadding, baseMenuHeight + baseMenuTextPadding, fontSize, WHITE);
+        // Greyed out when there is no database to draw from
+        DrawText("New Winnable Game", baseMenuFileX + baseMenuTextPadding, baseMenuHeight + baseMenuItemHeight + baseMenuTextPadding,
+                 fontSize, winnableDeals.size() > 0 ? WHITE : GRAY);
+        DrawText("Hint", baseMenuFileX + baseMenuTextPadding, baseMenuHeight + baseMenuItemHeight * 2 + baseMenuTextPadding, fontSize, WHITE);
 #ifndef EMSCRIPTEN_BUILD        
-        DrawText("Save", baseMenuFileX + baseMenuTextPadding, baseMenuHeight + baseMenuItemHeight + baseMenuTextPadding, fontSize, WHITE);
-        DrawText("Load", baseMenuFileX + baseMenuTextPadding, baseMenuHeight + baseMenuItemHeight * 2 + baseMenuTextPadding, fontSize, WHITE);
-        DrawText("Exit", baseMenuFileX + baseMenuTextPadding, baseMenuHeight + baseMenuItemHeight * 3 + baseMenuTextPadding, fontSize, WHITE);
+        DrawText("Save", baseMenuFileX + baseMenuTextPadding, baseMenuHeight + baseMenuItemHeight * 3 + baseMenuTextPadding, fontSize, WHITE);
+        DrawText("Load", baseMenuFileX + baseMenuTextPadding, baseMenuHeight + baseMenuItemHeight * 4 + baseMenuTextPadding, fontSize, WHITE);
+        DrawText("Exit", baseMenuFileX + baseMenuTextPadding, baseMenuHeight + baseMenuItemHeight * 5 + baseMenuTextPadding, fontSize, WHITE);
 #endif
     }
 
@@ -1047,6 +766,7 @@ void Solitaire::draw() {
                                "Controls:\n"
                                "- Drag cards to move them\n"
                                "- Double click to auto-move cards to foundation\n"
+                               "- Ctrl+Z to undo, Ctrl+Y to redo\n"
                                "- Use the menu for game options\n\n";
 
         // Calculate dialog dimensions
@@ -1103,4 +823,23 @@ void Solitaire::draw() {
         fontSize = static_cast<int>(40);
         DrawText("You Win!", baseWindowWidth/2 - 100, baseWindowHeight/2, fontSize, WHITE);
     }
+
+    // Rebuilds for a new window size happen behind the current atlas, only
+    // the first load is shown
+    if (!CardRenderer::areTexturesLoaded()) {
+        DrawText(TextFormat("Loading cards %d%%", static_cast<int>(CardRenderer::getLoadingProgress() * 100)),
+                 baseMenuTextPadding, baseWindowHeight - 10 - baseMenuTextPadding, 10, WHITE);
+    }
+
+    // F2 shows how the cards of this frame were batched
+    if (showRenderStats) {
+        const CardRenderStats& stats = CardRenderer::getStats();
+        const char* statsText = TextFormat("cards %d  texture switches %d", stats.cardsDrawn, stats.textureSwitches);
+        DrawText(statsText, baseWindowWidth - MeasureText(statsText, 10) - baseMenuTextPadding,
+                 baseWindowHeight - 10 - baseMenuTextPadding, 10, WHITE);
+        const char* loopText = TextFormat("frames drawn %llu of %llu  cpu %.1f%%", (unsigned long long)loopStats.framesDrawn,
+                                          (unsigned long long)loopStats.framesPresented, loopStats.cpuPercent);
+        DrawText(loopText, baseWindowWidth - MeasureText(loopText, 10) - baseMenuTextPadding,
+                 baseWindowHeight - 25 - baseMenuTextPadding, 10, WHITE);
+    }
 } 
\ No newline at end of file
@@ -3,28 +3,38 @@
 #include <vector>
 #include <string>
 #include <chrono>
+#include "BoardLayout.h"
 #include "Card.h"
+#include "AutoPlay.h"
+#include "CardRenderer.h"
+#include "DealDatabase.h"
+#include "HintEngine.h"
+#include "Journal.h"
+#include "Klondike.h"
+#include "Random.h"
+#include "WinEstimator.h"
 
 // Define debug flag
 #define DEBUG 1
 
-// Base dimensions (unscaled)
-const int baseCardWidth = 71;
-const int baseCardHeight = 96;
-const int baseCardSpacing = 20;
-const int baseTableauSpacing = 100;
-const int baseWindowWidth = 800;
-const int baseWindowHeight = 600;
-const int baseMenuHeight = 30;
+// Base dimensions (unscaled), the board itself is laid out by BoardLayout
 const int baseMenuFileX = 160;
 const int baseMenuFileWidth = 100;
+const int baseMenuFileDropdownWidth = 200;  // Wide enough for "New Winnable Game"
 const int baseMenuHelpX = 260;  // Position of Help menu
 const int baseMenuHelpWidth = 100;  // Width of Help menu
 const int baseMenuItemHeight = 25;
 const int baseMenuTextPadding = 5;
-const int baseMenuDropdownHeight = baseMenuItemHeight * 4;  // 4 menu items
+const int baseMenuDropdownHeight = baseMenuItemHeight * 6;  // 6 menu items
 const int baseMenuHelpDropdownHeight = baseMenuItemHeight * 1;  // 1 menu item for Help
 
+// Main loop counters for the F2 overlay, kept by main
+struct LoopStats {
+    uint64_t framesPresented;
+    uint64_t framesDrawn;  // Frames that redrew the board instead of presenting the last one again
+    float cpuPercent;      // Process CPU time over wall time since the previous redraw
+};
+
 class Solitaire {
 public:
     Solitaire();
@@ -37,47 +47,72 @@ public:
     void update();
     void draw();
     bool shouldExit() const { return shouldClose; }  // New getter method
+    // True when the last update() changed anything on screen. Frames without
+    // input, loading or a state change can present the previous picture.
+    bool needsRedraw() const { return redrawNeeded; }
+    // True when nothing will change before the next input event, so the main
+    // loop may block waiting for one
+    bool isIdle() const { return !redrawNeeded && !autoPlayPending && !CardRenderer::isBusy() && !hints.isSearching() && !winEstimator.isRunning(); }
+    void setLoopStats(const LoopStats& stats) { loopStats = stats; }
+    void newGame(uint32_t dealNumber);  // Starts the numbered deal, see Klondike::newGame
 
 private:
     // Game state
-    std::vector<std::vector<Card>> tableau;
-    std::vector<std::vector<Card>> foundations;
-    std::vector<Card> stock;
-    std::vector<Card> waste;
-    std::vector<Card> draggedCards;
+    Klondike klondike;  // Rules and piles, everything below is presentation state
+    BoardLayout layout;  // Card positions for the current Klondike state
+    // A drag is a view of its source pile: the cards from draggedStartIndex
+    // to the top stay in the pile until the drop moves them
     int draggedStartIndex;
-    std::vector<Card>* draggedSourcePile;
+    int draggedSourcePile;  // PileId of the dragged cards, or noPile
+    uint32_t draggedVersion;  // Klondike state version the view was taken in
     bool gameWon;
     Vector2 dragOffset;  // Track the offset between mouse and card position during drag
     double lastDealTime;  // Track when the last card was dealt to waste
-    Card* lastDrawnCard;  // Track the last card that was drawn from stock
+    Xoshiro256 dealPicker;  // Picks the deal number for New Game
+    DealDatabase winnableDeals;  // Solved draw-one seeds from assets/winnable.db, if present
+    JournalWriter journal;  // Records the moves of the current game
+    HintEngine hints;  // File > Hint, searches on its own thread
+    uint32_t shownHintRevision;  // Hint::revision of the last drawn frame
+    bool autoPlayPending;  // The player moved, safe moves may follow
+    bool autoCompleting;  // Auto-complete started, it runs until the game is won or undone
+    WinEstimator winEstimator;  // Win chance shown in the menu bar
 
     // Menu state
     bool menuOpen;
     bool helpMenuOpen;  // New state for Help menu
     bool shouldClose;
     bool aboutDialogOpen;  // New state for About dialog
+    bool showRenderStats;  // F2 toggles the card batching counters
+
+    // Board without the dragged cards, rendered once when a drag starts
+    RenderTexture2D boardLayer;
+    uint32_t boardLayerVersion;  // Klondike state version the layer shows
+    int boardLayerSourcePile;    // Drag the layer was rendered for
+    int boardLayerStartIndex;
+
+    // Redraw tracking
+    bool redrawNeeded;
+    uint32_t drawnVersion;  // Klondike state version of the last drawn frame
+    LoopStats loopStats;
 
     void handleMenuClick(Vector2 pos);
     void showAboutDialog();  // New method to show About dialog
 
     // Helper methods
+    void drawBoard();  // Everything below the dragged cards and the menus
+    void drawHint(const Hint& hint);  // Outlines the cards and the pile of the hinted move
+    void cacheBoardLayer();
+    bool isBoardLayerCurrent() const;
     void resetGame();
+    void resetWinnableGame();  // New game from winnableDeals, does nothing without one
+    void startJournal();  // Restarts the journal from the current state
     void loadCards();
-    void dealCards();
-    void returnDraggedCards(); // Helper to return dragged cards to original position
-    std::vector<Card>* getPileAtPos(Vector2 pos);
-    bool canMoveToTableau(const Card& card, const std::vector<Card>& targetPile);
-    bool canMoveToFoundation(const Card& card, const std::vector<Card>& targetPile);
-    bool moveCards(std::vector<Card>& sourcePile, std::vector<Card>& targetPile, 
-                  int startIndex, int endIndex = -1);
-    std::vector<Card>* findValidFoundationPile(const Card& card);
-    bool checkWin();
-
-    // Helper method to get the next value in sequence
-    std::string getNextValue(const std::string& value);
+    void returnDraggedCards(); // Helper to drop the dragged cards back on their source pile
+    bool isDragging() const { return draggedSourcePile != noPile; }
+    int getPileAtPos(Vector2 pos);  // Returns the PileId under pos, or noPile
 
     // Save and load game methods
     bool saveGame();
     bool loadGame();
+    bool loadLegacyGame();  // Reads the JSON save written by older versions
 }; 
\ No newline at end of file
@@ -0,0 +1,522 @@
+#include "Solver.h"
+#include "Random.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+const int maxColumnCards = 20;  // Six face-down cards under a king-to-ace run
+const int maxTalonCards = 24;
+const int maxStepsPerNode = 160;
+const int noColumn = -1;  // Source of a talon or foundation card in addTableauTargets
+const uint64_t cancelCheckMask = 4095;  // Nodes between two polls of the cancel flag
+
+enum StepKind : uint8_t {
+    StepTableauToFoundation,  // from = column
+    StepTalonToFoundation,    // index = talon position
+    StepTableauToTableau,     // from = column, index = first moved card, to = column
+    StepTalonToTableau,       // index = talon position, to = column
+    StepFoundationToTableau   // from = suit, to = column
+};
+
+struct ZobristKeys {
+    uint64_t column[cardDeckSize][maxColumnCards][2];  // [card][depth][face down]
+    uint64_t talon[cardDeckSize][maxTalonCards];
+    uint64_t foundation[cardSuitCount][cardRankCount + 1];
+    uint64_t cursor[maxTalonCards + 1];  // [waste top + 1], for rules where it matters
+
+    ZobristKeys() {
+        uint64_t state = 0x5EED5EED5EED5EEDull;
+        for (auto& card : column)
+            for (auto& depth : card)
+                for (auto& key : depth)
+                    key = splitMix64(state);
+        for (auto& card : talon)
+            for (auto& key : card)
+                key = splitMix64(state);
+        for (auto& suit : foundation)
+            for (auto& key : suit)
+                key = splitMix64(state);
+        for (auto& key : cursor)
+            key = splitMix64(state);
+    }
+};
+
+const ZobristKeys& zobrist() {
+    static const ZobristKeys keys;
+    return keys;
+}
+
+} // namespace
+
+// Compact position searched by the solver. Cards are stored without the
+// face-up flag; the first faceDown cards of a column are the hidden ones.
+// The talon lists the waste from bottom to top followed by the stock in draw
+// order, and cursor is the position of the waste top.
+struct SolverPosition {
+    Card columns[tableauPileCount][maxColumnCards];
+    uint8_t columnSize[tableauPileCount];
+    uint8_t faceDown[tableauPileCount];
+    uint8_t faceDownTotal;
+    uint8_t foundation[cardSuitCount];  // Height per suit
+    Card talon[maxTalonCards];
+    uint8_t talonSize;
+    int8_t cursor;
+};
+
+namespace {
+
+typedef SolverPosition Position;
+typedef SolverStep Step;
+
+template <class Rules>
+uint64_t hashPosition(const Position& p) {
+    const ZobristKeys& keys = zobrist();
+    uint64_t hash = 0;
+    // Columns are summed so that swapping two columns gives the same hash
+    for (int c = 0; c < tableauPileCount; c++) {
+        uint64_t columnHash = 0;
+        for (int i = 0; i < p.columnSize[c]; i++) {
+            columnHash ^= keys.column[p.columns[c][i].getIndex()][i][i < p.faceDown[c]];
+        }
+        hash += columnHash;
+    }
+    for (int s = 0; s < cardSuitCount; s++) {
+        hash ^= keys.foundation[s][p.foundation[s]];
+    }
+    for (int i = 0; i < p.talonSize; i++) {
+        hash ^= keys.talon[p.talon[i].getIndex()][i];
+    }
+    // Drawing one card with unlimited redeals reaches every talon card, so
+    // there the cursor is left out of the hash
+    if (Rules::drawCount > 1) {
+        hash ^= keys.cursor[p.cursor + 1];
+    }
+    return hash;
+}
+
+bool canFound(const Position& p, Card card) {
+    return p.foundation[card.getSuit()] + 1 == card.getValue();
+}
+
+bool isSafe(const Position& p, Card card) {
+    return isSafeFoundationCard(card, p.foundation);
+}
+
+template <class Rules>
+bool canStack(const Position& p, Card card, int column) {
+    if (p.columnSize[column] == 0) {
+        return Rules::startsTableau(card);
+    }
+    return Rules::stacksOnTableau(card, p.columns[column][p.columnSize[column] - 1]);
+}
+
+template <class Rules>
+bool talonReachable(const Position& p, int index) {
+    return Rules::talonReachable(index, p.cursor, p.talonSize);
+}
+
+void removeFromColumn(Position& p, int column, int count) {
+    p.columnSize[column] -= count;
+    if (p.columnSize[column] > 0 && p.faceDown[column] == p.columnSize[column]) {
+        p.faceDown[column]--;
+        p.faceDownTotal--;
+    }
+}
+
+void pushToColumn(Position& p, int column, Card card) {
+    p.columns[column][p.columnSize[column]++] = card;
+}
+
+Card takeFromTalon(Position& p, int index) {
+    Card card = p.talon[index];
+    std::memmove(p.talon + index, p.talon + index + 1, p.talonSize - index - 1);
+    p.talonSize--;
+    p.cursor = static_cast<int8_t>(index - 1);
+    return card;
+}
+
+void applyStep(Position& p, const Step& step) {
+    switch (step.kind) {
+        case StepTableauToFoundation: {
+            Card card = p.columns[step.from][p.columnSize[step.from] - 1];
+            p.foundation[card.getSuit()]++;
+            removeFromColumn(p, step.from, 1);
+            break;
+        }
+        case StepTalonToFoundation: {
+            Card card = takeFromTalon(p, step.index);
+            p.foundation[card.getSuit()]++;
+            break;
+        }
+        case StepTableauToTableau: {
+            int count = p.columnSize[step.from] - step.index;
+            std::memcpy(&p.columns[step.to][p.columnSize[step.to]], &p.columns[step.from][step.index], count);
+            p.columnSize[step.to] += count;
+            removeFromColumn(p, step.from, count);
+            break;
+        }
+        case StepTalonToTableau:
+            pushToColumn(p, step.to, takeFromTalon(p, step.index));
+            break;
+        case StepFoundationToTableau:
+            pushToColumn(p, step.to, Card(static_cast<CardSuit>(step.from), p.foundation[step.from]));
+            p.foundation[step.from]--;
+            break;
+    }
+}
+
+Step makeStep(StepKind kind, int from, int index, int to) {
+    return {kind, static_cast<uint8_t>(from), static_cast<uint8_t>(index), static_cast<uint8_t>(to)};
+}
+
+int firstEmptyColumn(const Position& p) {
+    for (int c = 0; c < tableauPileCount; c++) {
+        if (p.columnSize[c] == 0) {
+            return c;
+        }
+    }
+    return -1;
+}
+
+// Appends the tableau destinations for card, sending kings only to the first
+// empty column. from is the column the card leaves, which is never a target,
+// or noColumn when it comes from the talon or a foundation.
+template <class Rules>
+int addTableauTargets(const Position& p, Card card, int from, StepKind kind, int index, int emptyColumn, Step* steps, int count) {
+    for (int c = 0; c < tableauPileCount && count < maxStepsPerNode; c++) {
+        if (c == from || p.columnSize[c] == 0) {
+            continue;
+        }
+        if (canStack<Rules>(p, card, c)) {
+            steps[count++] = makeStep(kind, from, index, c);
+        }
+    }
+    if (emptyColumn >= 0 && card.getValue() == 13 && count < maxStepsPerNode) {
+        steps[count++] = makeStep(kind, from, index, emptyColumn);
+    }
+    return count;
+}
+
+// Fills steps in the order they are tried and returns how many there are.
+// A safe foundation move is returned on its own since it never hurts.
+template <class Rules>
+int generateSteps(const Position& p, Step* steps) {
+    int count = 0;
+
+    for (int c = 0; c < tableauPileCount; c++) {
+        if (p.columnSize[c] > 0) {
+            Card top = p.columns[c][p.columnSize[c] - 1];
+            if (canFound(p, top) && isSafe(p, top)) {
+                steps[0] = makeStep(StepTableauToFoundation, c, 0, 0);
+                return 1;
+            }
+        }
+    }
+    // Taking a card out of a draw-three talon changes which cards the later
+    // turns show, so there a talon card is never forced
+    for (int i = 0; i < p.talonSize && Rules::drawCount == 1; i++) {
+        if (canFound(p, p.talon[i]) && isSafe(p, p.talon[i])) {
+            steps[0] = makeStep(StepTalonToFoundation, 0, i, 0);
+            return 1;
+        }
+    }
+
+    // Foundation moves
+    for (int c = 0; c < tableauPileCount; c++) {
+        if (p.columnSize[c] > 0 && canFound(p, p.columns[c][p.columnSize[c] - 1])) {
+            steps[count++] = makeStep(StepTableauToFoundation, c, 0, 0);
+        }
+    }
+    for (int i = 0; i < p.talonSize; i++) {
+        if (talonReachable<Rules>(p, i) && canFound(p, p.talon[i])) {
+            steps[count++] = makeStep(StepTalonToFoundation, 0, i, 0);
+        }
+    }
+
+    int emptyColumn = firstEmptyColumn(p);
+
+    // Whole runs that turn over a face-down card, deepest columns first
+    int order[tableauPileCount];
+    for (int c = 0; c < tableauPileCount; c++) {
+        order[c] = c;
+    }
+    std::sort(order, order + tableauPileCount, [&](int a, int b) { return p.faceDown[a] > p.faceDown[b]; });
+    for (int c : order) {
+        if (p.faceDown[c] > 0) {
+            Card card = p.columns[c][p.faceDown[c]];
+            count = addTableauTargets<Rules>(p, card, c, StepTableauToTableau, p.faceDown[c], emptyColumn, steps, count);
+        }
+    }
+
+    // Talon cards onto the tableau
+    for (int i = 0; i < p.talonSize; i++) {
+        if (talonReachable<Rules>(p, i)) {
+            count = addTableauTargets<Rules>(p, p.talon[i], noColumn, StepTalonToTableau, i, emptyColumn, steps, count);
+        }
+    }
+
+    // Remaining tableau moves: emptying a column, or splitting a run
+    for (int c = 0; c < tableauPileCount; c++) {
+        for (int i = p.faceDown[c]; i < p.columnSize[c]; i++) {
+            if (i == p.faceDown[c] && p.faceDown[c] > 0) {
+                continue;  // Already generated above
+            }
+            Card card = p.columns[c][i];
+            // A king at the bottom of a column has nowhere better to go
+            int target = (i == 0) ? -1 : emptyColumn;
+            count = addTableauTargets<Rules>(p, card, c, StepTableauToTableau, i, target, steps, count);
+        }
+    }
+
+    // Taking a card back down from a foundation, unless it would be forced straight back
+    for (int s = 0; s < cardSuitCount; s++) {
+        if (p.foundation[s] > 0) {
+            Card card(static_cast<CardSuit>(s), p.foundation[s]);
+            if (!isSafe(p, card)) {
+                int first = count;
+                count = addTableauTargets<Rules>(p, card, noColumn, StepFoundationToTableau, 0, emptyColumn, steps, count);
+                for (int i = first; i < count; i++) {
+                    steps[i].from = static_cast<uint8_t>(s);
+                }
+            }
+        }
+    }
+
+    return count;
+}
+
+Position makePosition(const KlondikeState& game) {
+    Position p;
+    std::memset(&p, 0, sizeof(p));
+    for (int c = 0; c < tableauPileCount; c++) {
+        const CardPile& pile = game.tableau(c);
+        for (Card card : pile) {
+            if (!card.isFaceUp()) {
+                p.faceDown[c]++;
+            }
+            p.columns[c][p.columnSize[c]++] = Card::fromBits(card.getId());
+        }
+        p.faceDownTotal += p.faceDown[c];
+    }
+    for (int f = 0; f < foundationPileCount; f++) {
+        const CardPile& pile = game.foundation(f);
+        if (!pile.empty()) {
+            p.foundation[pile.back().getSuit()] = static_cast<uint8_t>(pile.back().getValue());
+        }
+    }
+    for (Card card : game.waste()) {
+        p.talon[p.talonSize++] = Card::fromBits(card.getId());
+    }
+    p.cursor = static_cast<int8_t>(p.talonSize - 1);
+    const CardPile& stock = game.stock();
+    for (auto it = stock.rbegin(); it != stock.rend(); ++it) {
+        p.talon[p.talonSize++] = Card::fromBits(it->getId());
+    }
+    return p;
+}
+
+bool isValidPosition(const KlondikeState& game) {
+    for (int c = 0; c < tableauPileCount; c++) {
+        if (game.tableau(c).size() > static_cast<size_t>(maxColumnCards)) {
+            return false;
+        }
+    }
+    return game.stock().size() + game.waste().size() <= static_cast<size_t>(maxTalonCards);
+}
+
+} // namespace
+
+template <class Rules>
+BasicSolver<Rules>::BasicSolver(const SolverOptions& options)
+    : options(options), tableMask(0), generation(0), nodes(0), nodeLimit(0), outOfBudget(false) {
+    int bits = std::max(10, std::min(this->options.tableBits, 30));
+    table.assign(size_t(1) << bits, 0);
+    tableMask = (uint64_t(1) << bits) - 1;
+}
+
+template <class Rules>
+bool BasicSolver<Rules>::visit(uint64_t hash) {
+    // The low 16 bits of an entry hold the generation of the solve that wrote
+    // it, so starting a new solve does not need to clear the table
+    const int probes = 8;
+    uint64_t key = (hash & ~uint64_t(0xFFFF)) | generation;
+    uint64_t home = (hash >> 16) & tableMask;
+    for (int i = 0; i < probes; i++) {
+        uint64_t& entry = table[(home + i) & tableMask];
+        if (entry == key) {
+            return false;
+        }
+        if ((entry & 0xFFFF) != generation) {
+            entry = key;
+            return true;
+        }
+    }
+    // Neighbourhood full, overwrite the home slot. Forgetting a position can
+    // only cost a re-search.
+    table[home] = key;
+    return true;
+}
+
+template <class Rules>
+void BasicSolver<Rules>::finishVisible(Position& p) {
+    // With every tableau card face up the lowest missing foundation card is
+    // always on top of a column or in the talon, so greedy play wins
+    bool progress = true;
+    while (progress) {
+        progress = false;
+        for (int c = 0; c < tableauPileCount; c++) {
+            if (p.columnSize[c] > 0 && canFound(p, p.columns[c][p.columnSize[c] - 1])) {
+                Step step = makeStep(StepTableauToFoundation, c, 0, 0);
+                applyStep(p, step);
+                path.push_back(step);
+                progress = true;
+            }
+        }
+        for (int i = 0; i < p.talonSize; i++) {
+            if (canFound(p, p.talon[i])) {
+                Step step = makeStep(StepTalonToFoundation, 0, i, 0);
+                applyStep(p, step);
+                path.push_back(step);
+                progress = true;
+                break;
+            }
+        }
+    }
+}
+
+template <class Rules>
+bool BasicSolver<Rules>::search(const Position& position, int depth) {
+    // Stuck talon cards can still lose a draw-three game, so there the
+    // shortcut waits for the talon to be played out too
+    if (position.faceDownTotal == 0 && (Rules::drawCount == 1 || position.talonSize == 0)) {
+        Position rest = position;
+        finishVisible(rest);
+        return true;
+    }
+    if (nodes >= nodeLimit || depth >= options.maxDepth) {
+        outOfBudget = true;
+        return false;
+    }
+    nodes++;
+    if ((nodes & cancelCheckMask) == 0 && options.cancel && options.cancel->load(std::memory_order_relaxed)) {
+        nodeLimit = nodes;
+    }
+    if (!visit(hashPosition<Rules>(position))) {
+        return false;
+    }
+
+    Step steps[maxStepsPerNode];
+    int count = generateSteps<Rules>(position, steps);
+    for (int i = 0; i < count; i++) {
+        Position child = position;
+        applyStep(child, steps[i]);
+        path.push_back(steps[i]);
+        if (search(child, depth + 1)) {
+            return true;
+        }
+        path.pop_back();
+        if (nodes >= nodeLimit) {
+            outOfBudget = true;
+            return false;
+        }
+    }
+    return false;
+}
+
+template <class Rules>
+void BasicSolver<Rules>::expand(const Game& game, SolverResult& result) const {
+    Game sim = game;
+    std::vector<Move>& moves = result.moves;
+
+    auto play = [&](const Move& move) {
+        moves.push_back(move);
+        return sim.applyMove(move);
+    };
+    // Turns the talon until position index is on top of the waste, recycling
+    // when the stock runs out. Two passes reach any card the search could pick.
+    auto bringToWaste = [&](int index) {
+        for (int turns = 0; static_cast<int>(sim.waste().size()) - 1 != index; turns++) {
+            if (turns > 2 * maxTalonCards || !play(sim.stock().empty() ? Move::recycle() : Move::draw())) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    for (const Step& step : path) {
+        bool ok = true;
+        switch (step.kind) {
+            case StepTableauToFoundation: {
+                const CardPile& pile = sim.tableau(step.from);
+                int target = sim.findValidFoundationPile(pile.back());
+                ok = play(Move::cards(PileTableau0 + step.from, pile.size() - 1, target));
+                break;
+            }
+            case StepTalonToFoundation: {
+                if (!bringToWaste(step.index)) {
+                    ok = false;
+                    break;
+                }
+                int target = sim.findValidFoundationPile(sim.waste().back());
+                ok = play(Move::cards(PileWaste, sim.waste().size() - 1, target));
+                break;
+            }
+            case StepTableauToTableau:
+                ok = play(Move::cards(PileTableau0 + step.from, step.index, PileTableau0 + step.to));
+                break;
+            case StepTalonToTableau:
+                ok = bringToWaste(step.index) &&
+                     play(Move::cards(PileWaste, sim.waste().size() - 1, PileTableau0 + step.to));
+                break;
+            case StepFoundationToTableau:
+                for (int f = 0; f < foundationPileCount; f++) {
+                    const CardPile& pile = sim.foundation(f);
+                    if (!pile.empty() && pile.back().getSuit() == step.from) {
+                        ok = play(Move::cards(PileFoundation0 + f, pile.size() - 1, PileTableau0 + step.to));
+                        break;
+                    }
+                }
+                break;
+        }
+        if (!ok) {
+            // The compact position and the engine disagree, never report a broken line
+            result.status = SolverBudgetExceeded;
+            moves.clear();
+            return;
+        }
+    }
+}
+
+template <class Rules>
+SolverResult BasicSolver<Rules>::solve(const Game& game) {
+    auto start = std::chrono::steady_clock::now();
+    SolverResult result;
+
+    if (++generation == 0) {
+        std::fill(table.begin(), table.end(), 0);
+        generation = 1;
+    }
+    nodes = 0;
+    nodeLimit = options.nodeBudget;
+    outOfBudget = false;
+    path.clear();
+
+    if (isValidPosition(game)) {
+        Position root = makePosition(game);
+        if (search(root, 0)) {
+            result.status = SolverSolved;
+            expand(game, result);
+        } else {
+            result.status = outOfBudget ? SolverBudgetExceeded : SolverUnsolvable;
+        }
+    }
+
+    result.nodes = nodes;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+template class BasicSolver<DrawOneRules>;
+template class BasicSolver<DrawThreeRules>;
@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "Klondike.h"
+
+enum SolverStatus : uint8_t {
+    SolverSolved = 0,          // moves holds a winning sequence
+    SolverUnsolvable = 1,      // The whole reachable state space was searched without a win
+    SolverBudgetExceeded = 2   // Gave up after nodeBudget nodes or maxDepth moves, or was cancelled
+};
+
+struct SolverOptions {
+    uint64_t nodeBudget = 2000000;  // Maximum number of positions to expand
+    int maxDepth = 300;             // Maximum number of solver steps on one line
+    int tableBits = 20;             // The transposition table holds 2^tableBits entries
+    // Polled every few thousand nodes from the solving thread; once another
+    // thread sets it the search stops as if the node budget had run out
+    const std::atomic<bool>* cancel = nullptr;
+};
+
+struct SolverResult {
+    SolverStatus status = SolverBudgetExceeded;
+    std::vector<Move> moves;  // Concrete moves for Klondike::applyMove, including draws and recycles
+    uint64_t nodes = 0;
+    double seconds = 0.0;
+
+    double nodesPerSecond() const { return seconds > 0.0 ? nodes / seconds : 0.0; }
+};
+
+// Step of a solution in the compact position, expanded into Moves at the end
+struct SolverStep {
+    uint8_t kind;
+    uint8_t from;
+    uint8_t index;
+    uint8_t to;
+};
+struct SolverPosition;
+
+// Depth-first Klondike solver with full knowledge of the face-down cards.
+//
+// The search runs on a compact copy of the position:
+//  - the stock and waste are treated as one cyclic talon, so any talon card
+//    that Rules::talonReachable() allows can be played in a single step
+//    instead of stepping through draws,
+//  - positions are identified by Zobrist hashes in a fixed-size
+//    transposition table; tableau columns are combined order-independently
+//    so positions that only differ by column order are searched once,
+//  - safe foundation moves are forced and kings only move to the first
+//    empty column.
+//
+// The solver is compiled once per rule set in Solver.cpp. A BasicSolver owns
+// its transposition table and can be reused for many solves.
+template <class Rules>
+class BasicSolver {
+public:
+    typedef BasicKlondike<Rules> Game;
+
+    explicit BasicSolver(const SolverOptions& options = SolverOptions());
+
+    SolverResult solve(const Game& game);
+
+    const SolverOptions& getOptions() const { return options; }
+    void setNodeBudget(uint64_t budget) { options.nodeBudget = budget; }
+
+private:
+    SolverOptions options;
+    std::vector<uint64_t> table;
+    uint64_t tableMask;
+    uint16_t generation;
+
+    // Per-solve state
+    uint64_t nodes;
+    uint64_t nodeLimit;  // options.nodeBudget, lowered to nodes on cancel
+    bool outOfBudget;
+    std::vector<SolverStep> path;
+
+    bool search(const SolverPosition& position, int depth);
+    bool visit(uint64_t hash);  // Returns false if the hash was already in the table
+    void finishVisible(SolverPosition& position);
+    void expand(const Game& game, SolverResult& result) const;
+};
+
+extern template class BasicSolver<DrawOneRules>;
+extern template class BasicSolver<DrawThreeRules>;
+
+typedef BasicSolver<DrawOneRules> Solver;
+typedef BasicSolver<DrawThreeRules> SolverDrawThree;
@@ -0,0 +1,131 @@
+#include "Trace.h"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const size_t maxEventsPerThread = 1 << 20;  // About a quarter hour of frames
+
+struct TraceEvent {
+    const char* name;
+    int64_t start;
+    int64_t end;  // Equal to start for instant events
+    bool instant;
+};
+
+struct ThreadBuffer {
+    int tid;
+    const char* name = nullptr;
+    std::vector<TraceEvent> events;
+};
+
+std::mutex buffersMutex;  // Guards the list, not the buffers in it
+std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+std::string tracePath;
+Clock::time_point traceStart;
+
+// Buffers outlive their threads, so the decode workers' events are kept
+ThreadBuffer& threadBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        buffers.emplace_back(new ThreadBuffer());
+        buffer = buffers.back().get();
+        buffer->tid = static_cast<int>(buffers.size());
+        buffer->events.reserve(4096);
+    }
+    return *buffer;
+}
+
+void writeString(std::ofstream& file, const char* text) {
+    file << '"';
+    for (const char* c = text; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            file << '\\';
+        }
+        file << *c;
+    }
+    file << '"';
+}
+
+} // namespace
+
+std::atomic<bool> Trace::enabled(false);
+
+void Trace::start(const std::string& path) {
+    tracePath = path;
+    traceStart = Clock::now();
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+int64_t Trace::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - traceStart).count();
+}
+
+void Trace::complete(const char* name, int64_t start, int64_t end) {
+    ThreadBuffer& buffer = threadBuffer();
+    if (buffer.events.size() < maxEventsPerThread) {
+        buffer.events.push_back({name, start, end, false});
+    }
+}
+
+void Trace::instant(const char* name) {
+    if (!isEnabled()) {
+        return;
+    }
+    ThreadBuffer& buffer = threadBuffer();
+    int64_t time = now();
+    if (buffer.events.size() < maxEventsPerThread) {
+        buffer.events.push_back({name, time, time, true});
+    }
+}
+
+void Trace::setThreadName(const char* name) {
+    if (isEnabled()) {
+        threadBuffer().name = name;
+    }
+}
+
+bool Trace::stop() {
+    if (!enabled.exchange(false)) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    std::ofstream file(tracePath);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    // Times are in microseconds, nanosecond precision is kept as decimals
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" << std::fixed << std::setprecision(3);
+    bool first = true;
+    for (const auto& buffer : buffers) {
+        if (buffer->name) {
+            file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+                 << ",\"args\":{\"name\":";
+            writeString(file, buffer->name);
+            file << "}}";
+            first = false;
+        }
+        for (const TraceEvent& event : buffer->events) {
+            file << (first ? "" : ",\n") << "{\"name\":";
+            writeString(file, event.name);
+            if (event.instant) {
+                file << ",\"ph\":\"i\",\"s\":\"t\",\"ts\":" << event.start / 1000.0;
+            } else {
+                file << ",\"ph\":\"X\",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << (event.end - event.start) / 1000.0;
+            }
+            file << ",\"pid\":1,\"tid\":" << buffer->tid << "}";
+            first = false;
+        }
+        buffer->events.clear();
+    }
+    file << "\n]}\n";
+    return file.good();
+}
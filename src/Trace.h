@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Chrome trace event recorder, for startup and frame timelines viewable in
+// Perfetto or chrome://tracing.
+//
+// TRACE_SCOPE("name") times the rest of the enclosing block. While tracing is
+// off a scope costs one relaxed atomic load. While it is on, each thread
+// appends to its own buffer without locking; stop() merges the buffers and
+// writes the JSON file. Names must be string literals, only the pointer is
+// kept.
+class Trace {
+public:
+    // Starts recording, the file is written by stop()
+    static void start(const std::string& path);
+    // Writes the trace and stops recording. Call it once the other traced
+    // threads have finished. Returns false if the file could not be written.
+    static bool stop();
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    // Nanoseconds since start()
+    static int64_t now();
+    static void complete(const char* name, int64_t start, int64_t end);
+    static void instant(const char* name);
+    // Shown as the thread's track name
+    static void setThreadName(const char* name);
+
+private:
+    static std::atomic<bool> enabled;
+};
+
+class TraceScope {
+public:
+    explicit TraceScope(const char* zone) : name(Trace::isEnabled() ? zone : nullptr), start(name ? Trace::now() : 0) {}
+    ~TraceScope() {
+        if (name) {
+            Trace::complete(name, start, Trace::now());
+        }
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    int64_t start;
+};
+
+#define TRACE_JOIN_(a, b) a##b
+#define TRACE_JOIN(a, b) TRACE_JOIN_(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_JOIN(traceScope, __LINE__)(name)
@@ -0,0 +1,308 @@
+#include "WinEstimator.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const double inlineSliceSeconds = 0.004;  // Web builds: rollout time per update()
+
+bool fitsFoundation(const RolloutSetup& d, Card card) {
+    return d.foundation[card.getSuit()] + 1 == card.getValue();
+}
+
+void popColumn(RolloutSetup& d, int column, int count) {
+    d.columnSize[column] -= count;
+    // Turn the new top card
+    if (d.columnSize[column] > 0 && d.faceDown[column] == d.columnSize[column]) {
+        d.faceDown[column]--;
+    }
+}
+
+// A column card can go onto, preferring a card over an empty column
+int tableauTarget(const RolloutSetup& d, Card card, int from) {
+    int empty = -1;
+    for (int c = 0; c < tableauPileCount; c++) {
+        if (c == from) {
+            continue;
+        }
+        int size = d.columnSize[c];
+        if (size == 0) {
+            if (empty < 0 && card.getValue() == cardRankCount) {
+                empty = c;
+            }
+        } else if (Card::stacksOnTableau(card, d.columns[c][size - 1])) {
+            return c;
+        }
+    }
+    return empty;
+}
+
+bool playFoundationMove(RolloutSetup& d) {
+    for (int c = 0; c < tableauPileCount; c++) {
+        if (d.columnSize[c] > 0 && fitsFoundation(d, d.columns[c][d.columnSize[c] - 1])) {
+            d.foundation[d.columns[c][d.columnSize[c] - 1].getSuit()]++;
+            popColumn(d, c, 1);
+            return true;
+        }
+    }
+    if (d.wasteSize > 0 && fitsFoundation(d, d.waste[d.wasteSize - 1])) {
+        d.foundation[d.waste[--d.wasteSize].getSuit()]++;
+        return true;
+    }
+    return false;
+}
+
+// Moves the face-up run of a column onto another column when that turns a
+// face-down card
+bool playRevealingMove(RolloutSetup& d) {
+    for (int c = 0; c < tableauPileCount; c++) {
+        int start = d.faceDown[c];
+        if (start == 0 || start >= d.columnSize[c]) {
+            continue;
+        }
+        int target = tableauTarget(d, d.columns[c][start], c);
+        if (target < 0) {
+            continue;
+        }
+        int count = d.columnSize[c] - start;
+        std::memcpy(&d.columns[target][d.columnSize[target]], &d.columns[c][start], count);
+        d.columnSize[target] += count;
+        popColumn(d, c, count);
+        return true;
+    }
+    return false;
+}
+
+bool playWasteToTableau(RolloutSetup& d) {
+    if (d.wasteSize == 0) {
+        return false;
+    }
+    Card card = d.waste[d.wasteSize - 1];
+    int target = tableauTarget(d, card, -1);
+    if (target < 0 || d.columnSize[target] >= RolloutSetup::maxColumnCards) {
+        return false;
+    }
+    d.columns[target][d.columnSize[target]++] = card;
+    d.wasteSize--;
+    return true;
+}
+
+// Every move but a stock turn adds a foundation card, turns a face-down card
+// or shrinks the talon, so the game ends once a whole pass through the talon
+// goes by without one
+bool playGreedy(RolloutSetup& d) {
+    int founded = 0;
+    for (int s = 0; s < cardSuitCount; s++) {
+        founded += d.foundation[s];
+    }
+    int idleTurns = 0;
+    while (founded < cardDeckSize) {
+        if (playFoundationMove(d)) {
+            founded++;
+            idleTurns = 0;
+            continue;
+        }
+        if (playRevealingMove(d) || playWasteToTableau(d)) {
+            idleTurns = 0;
+            continue;
+        }
+        if (idleTurns++ > d.stockSize + d.wasteSize) {
+            return false;
+        }
+        if (d.stockSize > 0) {
+            d.waste[d.wasteSize++] = d.stock[--d.stockSize];
+        } else if (d.wasteSize > 0) {
+            for (int i = 0; i < d.wasteSize; i++) {
+                d.stock[i] = d.waste[d.wasteSize - 1 - i];
+            }
+            d.stockSize = d.wasteSize;
+            d.wasteSize = 0;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool WinEstimator::prepare(const Klondike& game, RolloutSetup& setup) {
+    const CardPile& stock = game.stock();
+    const CardPile& waste = game.waste();
+    if (stock.size() > RolloutSetup::maxTalonCards || waste.size() > RolloutSetup::maxTalonCards) {
+        return false;
+    }
+
+    // Once the waste has been turned back into the stock, the player has
+    // seen every talon card in order
+    setup.stockUnknown = true;
+    for (size_t i = 0; i < game.undoCount(); i++) {
+        if (game.historyEntry(i).type == MoveTypeRecycle) {
+            setup.stockUnknown = false;
+            break;
+        }
+    }
+
+    int unknownCount = 0;
+    for (int c = 0; c < tableauPileCount; c++) {
+        const CardPile& pile = game.tableau(c);
+        if (pile.size() > RolloutSetup::maxColumnCards) {
+            return false;
+        }
+        int faceDown = 0;
+        while (faceDown < static_cast<int>(pile.size()) && !pile[faceDown].isFaceUp()) {
+            setup.unknown[unknownCount++] = pile[faceDown++];
+        }
+        std::copy(pile.begin(), pile.end(), setup.columns[c]);
+        setup.columnSize[c] = static_cast<uint8_t>(pile.size());
+        setup.faceDown[c] = static_cast<uint8_t>(faceDown);
+    }
+    game.foundationHeights(setup.foundation);
+    std::copy(stock.begin(), stock.end(), setup.stock);
+    setup.stockSize = static_cast<uint8_t>(stock.size());
+    std::copy(waste.begin(), waste.end(), setup.waste);
+    setup.wasteSize = static_cast<uint8_t>(waste.size());
+    if (setup.stockUnknown) {
+        for (Card card : stock) {
+            setup.unknown[unknownCount++] = card;
+        }
+    }
+    setup.unknownCount = static_cast<uint8_t>(unknownCount);
+    return true;
+}
+
+bool WinEstimator::rollout(const RolloutSetup& setup, Xoshiro256& rng) {
+    RolloutSetup d = setup;
+
+    // Deal a shuffle of the unknown cards into the places they could be
+    Card* cards = d.unknown;
+    for (int i = d.unknownCount - 1; i > 0; i--) {
+        std::swap(cards[i], cards[rng.below(i + 1)]);
+    }
+    int next = 0;
+    for (int c = 0; c < tableauPileCount; c++) {
+        for (int i = 0; i < d.faceDown[c]; i++) {
+            d.columns[c][i] = cards[next++];
+        }
+    }
+    if (d.stockUnknown) {
+        for (int i = 0; i < d.stockSize; i++) {
+            d.stock[i] = cards[next++];
+        }
+    }
+    return playGreedy(d);
+}
+
+WinEstimator::WinEstimator(uint32_t rollouts, unsigned threads)
+    : rolloutCount(rollouts), threadCount(threads ? threads : std::max(1u, std::thread::hardware_concurrency())),
+      stateVersion(0), running(false), estimateReady(false), setup(), seed(0),
+      wins(0), played(0), finishedWorkers(0), cancelFlag(false), inlineNext(0) {}
+
+WinEstimator::~WinEstimator() {
+    cancel();
+}
+
+void WinEstimator::start(const Klondike& game) {
+    start(game, (uint64_t(game.getDealNumber()) << 32) ^ game.getStateVersion());
+}
+
+void WinEstimator::start(const Klondike& game, uint64_t seed) {
+    cancel();
+    stateVersion = game.getStateVersion();
+    if (!prepare(game, setup)) {
+        estimateReady = false;
+        return;
+    }
+
+    this->seed = seed;
+    inlineRng.reseed(seed);
+    wins = 0;
+    played = 0;
+    finishedWorkers = 0;
+    cancelFlag = false;
+    inlineNext = 0;
+    running = true;
+    startTime = std::chrono::steady_clock::now();
+#ifndef __EMSCRIPTEN__
+    for (unsigned i = 0; i < threadCount; i++) {
+        workers.emplace_back(&WinEstimator::work, this, i);
+    }
+#endif
+}
+
+void WinEstimator::cancel() {
+    cancelFlag = true;
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    running = false;
+}
+
+void WinEstimator::work(unsigned index) {
+    // Worker i draws from the stream jumped i times, 2^128 draws apart
+    Xoshiro256 rng(seed);
+    for (unsigned i = 0; i < index; i++) {
+        rng.jump();
+    }
+    uint32_t begin = static_cast<uint32_t>(uint64_t(rolloutCount) * index / threadCount);
+    uint32_t end = static_cast<uint32_t>(uint64_t(rolloutCount) * (index + 1) / threadCount);
+    uint32_t localWins = 0;
+    uint32_t localPlayed = 0;
+    for (uint32_t i = begin; i < end && !cancelFlag.load(std::memory_order_relaxed); i++) {
+        localWins += rollout(setup, rng) ? 1 : 0;
+        localPlayed++;
+    }
+    wins.fetch_add(localWins, std::memory_order_relaxed);
+    played.fetch_add(localPlayed, std::memory_order_relaxed);
+    finishedWorkers.fetch_add(1, std::memory_order_release);
+}
+
+bool WinEstimator::update() {
+    if (!running) {
+        return false;
+    }
+#ifdef __EMSCRIPTEN__
+    // One stream, advanced slice by slice across frames
+    auto sliceStart = std::chrono::steady_clock::now();
+    while (inlineNext < rolloutCount) {
+        wins += rollout(setup, inlineRng) ? 1 : 0;
+        played++;
+        inlineNext++;
+        if ((inlineNext & 63) == 0 &&
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - sliceStart).count() >= inlineSliceSeconds) {
+            return false;
+        }
+    }
+#else
+    if (finishedWorkers.load(std::memory_order_acquire) < workers.size()) {
+        return false;
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+#endif
+    finish();
+    return true;
+}
+
+void WinEstimator::finish() {
+    estimate.rollouts = played;
+    estimate.wins = wins;
+    estimate.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    estimateReady = true;
+    running = false;
+}
+
+WinEstimate WinEstimator::estimateNow(const Klondike& game, uint32_t rollouts, unsigned threads, uint64_t seed) {
+    WinEstimator estimator(rollouts, threads);
+    estimator.start(game, seed);
+    if (!estimator.isRunning()) {
+        return WinEstimate();
+    }
+    while (!estimator.update()) {
+        std::this_thread::yield();
+    }
+    return estimator.getEstimate();
+}
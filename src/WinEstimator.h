@@ -0,0 +1,108 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "Klondike.h"
+#include "Random.h"
+
+struct WinEstimate {
+    uint32_t rollouts = 0;  // Rollouts played out
+    uint32_t wins = 0;
+    double seconds = 0.0;
+
+    float probability() const { return rollouts ? static_cast<float>(wins) / rollouts : 0.0f; }
+};
+
+// Cards of a position in the form the rollouts play on, with the cards the
+// player cannot know listed apart. Plain arrays only: copying one is a memcpy.
+struct RolloutSetup {
+    static const int maxColumnCards = 20;  // Six face-down cards under a king-to-ace run
+    static const int maxTalonCards = 24;
+
+    Card columns[tableauPileCount][maxColumnCards];
+    uint8_t columnSize[tableauPileCount];
+    uint8_t faceDown[tableauPileCount];
+    uint8_t foundation[cardSuitCount];  // Height per suit
+    Card stock[maxTalonCards];          // Top card last
+    uint8_t stockSize;
+    Card waste[maxTalonCards];          // Top card last
+    uint8_t wasteSize;
+
+    // The rollouts refill the face-down part of each column, then the stock
+    // if stockUnknown, with a shuffle of unknown[]. Once the player has
+    // recycled the waste every stock card has been seen.
+    bool stockUnknown;
+    Card unknown[cardDeckSize];
+    uint8_t unknownCount;
+};
+
+// Monte Carlo estimate of the chance to win from a position.
+//
+// Each rollout deals the unknown cards at random into their slots, so every
+// sampled deal agrees with what the player has seen, then plays it out with a
+// greedy policy: foundation moves, then moves that turn a face-down card, then
+// the waste onto the tableau, then the stock, until it wins or a full pass
+// through the talon changes nothing. The estimate is the share of wins. The
+// greedy player is weaker than a good human, so it is a floor more than a
+// forecast.
+//
+// Rollouts run on one worker per core, each drawing from its own jump() of
+// the same Xoshiro256 stream, and allocate nothing. Web builds have no
+// threads and play the rollouts a slice per update() instead.
+class WinEstimator {
+public:
+    static const uint32_t defaultRollouts = 10000;
+
+    explicit WinEstimator(uint32_t rollouts = defaultRollouts, unsigned threads = 0);
+    ~WinEstimator();
+
+    WinEstimator(const WinEstimator&) = delete;
+    WinEstimator& operator=(const WinEstimator&) = delete;
+
+    // Starts estimating game, dropping any estimate still running. Positions
+    // the rollouts cannot represent give no estimate. Without a seed, the
+    // samples are seeded from the deal number and the state version.
+    void start(const Klondike& game);
+    void start(const Klondike& game, uint64_t seed);
+    void cancel();
+    // Collects finished workers. Returns true when an estimate just completed.
+    bool update();
+    bool isRunning() const { return running; }
+    // The last completed estimate stays available while the next one runs
+    bool hasEstimate() const { return estimateReady; }
+    const WinEstimate& getEstimate() const { return estimate; }
+    // State version of the game passed to the last start()
+    uint32_t getStateVersion() const { return stateVersion; }
+
+    // Runs the whole estimate on the calling thread and its workers
+    static WinEstimate estimateNow(const Klondike& game, uint32_t rollouts, unsigned threads, uint64_t seed);
+
+    // Fills setup from game, returns false if a pile is too long for it
+    static bool prepare(const Klondike& game, RolloutSetup& setup);
+    // Plays one sampled deal of setup, returns true if the greedy policy won it
+    static bool rollout(const RolloutSetup& setup, Xoshiro256& rng);
+
+private:
+    uint32_t rolloutCount;
+    unsigned threadCount;
+    uint32_t stateVersion;
+    bool running;
+    bool estimateReady;
+    WinEstimate estimate;
+
+    RolloutSetup setup;
+    uint64_t seed;
+    std::chrono::steady_clock::time_point startTime;
+    std::atomic<uint32_t> wins;
+    std::atomic<uint32_t> played;
+    std::atomic<unsigned> finishedWorkers;
+    std::atomic<bool> cancelFlag;
+    std::vector<std::thread> workers;
+    uint32_t inlineNext;  // Web builds: rollouts played so far by update()
+    Xoshiro256 inlineRng;
+
+    void work(unsigned index);
+    void finish();
+};
@@ -1,5 +1,11 @@
+#include "FrameProfiler.h"
+#include "ProcessStats.h"
 #include "Solitaire.h"
+#include "Trace.h"
 #include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <raylib.h>
 
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
@@ -14,21 +20,121 @@ Solitaire* game = nullptr;
 // Global render texture for the game
 RenderTexture2D gameTarget;
 float gameScale = 1.0f;
+// Startup time, logged once the first frame is on screen
+std::chrono::steady_clock::time_point startupBegin;
+bool firstFramePresented = false;
+// Main loop counters; --always-redraw turns off frame skipping to compare
+LoopStats loopStats = {};
+double lastRedrawTime = 0.0;
+double lastRedrawCpu = 0.0;
+bool alwaysRedraw = false;
+// F3 shows the frame phase percentiles, F4 writes the kept frames to a CSV
+FrameProfiler profiler;
+bool showProfiler = false;
+static const char* profileCsvPath = "frame_profile.csv";
+static const double targetFrameSeconds = 1.0 / 60.0;
+
+// Drawn in screen space after the blit, so showing it needs no board redraw
+static void drawProfilerOverlay() {
+    const int fontSize = 10;
+    const int lineHeight = 12;
+    const int columnWidth = 50;
+    const int left = 10;
+    int lines = FramePhaseCount + 3;
+    int top = GetScreenHeight() - 10 - lineHeight * lines;
+    DrawRectangle(left - 5, top - 5, columnWidth * 5 + 10, lineHeight * lines + 10, Fade(BLACK, 0.7f));
+
+    DrawText(TextFormat("last %d frames, ms", static_cast<int>(profiler.size())), left, top, fontSize, WHITE);
+    const char* headings[] = {"p50", "p95", "p99", "max"};
+    for (int column = 0; column < 4; column++) {
+        DrawText(headings[column], left + columnWidth * (column + 1), top + lineHeight, fontSize, LIGHTGRAY);
+    }
+    for (int phase = 0; phase <= FramePhaseCount; phase++) {
+        FramePhaseStats stats = profiler.stats(phase);
+        float values[] = {stats.p50, stats.p95, stats.p99, stats.max};
+        int y = top + lineHeight * (phase + 2);
+        DrawText(FrameProfiler::phaseName(phase), left, y, fontSize, LIGHTGRAY);
+        for (int column = 0; column < 4; column++) {
+            DrawText(TextFormat("%.2f", values[column]), left + columnWidth * (column + 1), y, fontSize, WHITE);
+        }
+    }
+}
 
 
 void UpdateDrawFrame(void) {
     if (!game) return;
 
+    // The phases are wall-clock time on this thread. Draw calls are batched,
+    // so GPU work mostly lands in the target phase (EndTextureMode flushes)
+    // and in present.
+    TRACE_SCOPE("frame");
+    profiler.beginFrame();
     gameScale = MIN((float)GetScreenWidth() / baseWindowWidth, (float)GetScreenHeight() / baseWindowHeight);
-    game->update();
-    
-    // Begin rendering to the game target
-    BeginTextureMode(gameTarget);
-    ClearBackground(BLACK);
-    game->draw();
-    EndTextureMode();
+    profiler.begin(FramePhaseUpdate);
+    {
+        TRACE_SCOPE("update");
+        game->update();
+    }
+    profiler.end(FramePhaseUpdate);
+
+    if (IsKeyPressed(KEY_F3)) {
+        showProfiler = !showProfiler;
+    }
+    if (IsKeyPressed(KEY_F4)) {
+        if (profiler.writeCsv(profileCsvPath)) {
+            TraceLog(LOG_INFO, "Wrote %d frames to %s", static_cast<int>(profiler.size()), profileCsvPath);
+        } else {
+            TraceLog(LOG_WARNING, "Could not write %s", profileCsvPath);
+        }
+    }
+
+    // Render at the scale the card atlas was baked at, so cards are drawn
+    // texel for texel and only the final blit to the screen is filtered
+    float renderScale = CardRenderer::getAtlasScale();
+    int targetWidth = static_cast<int>(baseWindowWidth * renderScale);
+    int targetHeight = static_cast<int>(baseWindowHeight * renderScale);
+    bool targetChanged = gameTarget.texture.width != targetWidth || gameTarget.texture.height != targetHeight;
+    if (targetChanged) {
+        UnloadRenderTexture(gameTarget);
+        gameTarget = LoadRenderTexture(targetWidth, targetHeight);
+        SetTextureFilter(gameTarget.texture, TEXTURE_FILTER_BILINEAR);
+    }
+
+    // Redraw the board only when something changed, otherwise the target
+    // still holds the last frame and is presented again
+    loopStats.framesPresented++;
+    if (alwaysRedraw || targetChanged || game->needsRedraw()) {
+        double now = GetTime();
+        double cpu = processCpuSeconds();
+        if (now > lastRedrawTime) {
+            loopStats.cpuPercent = static_cast<float>(100.0 * (cpu - lastRedrawCpu) / (now - lastRedrawTime));
+        }
+        lastRedrawTime = now;
+        lastRedrawCpu = cpu;
+        loopStats.framesDrawn++;
+        game->setLoopStats(loopStats);
+
+        // Begin rendering to the game target, in base window coordinates
+        profiler.begin(FramePhaseTarget);
+        BeginTextureMode(gameTarget);
+        ClearBackground(BLACK);
+        Camera2D camera = { { 0.0f, 0.0f }, { 0.0f, 0.0f }, 0.0f, renderScale };
+        BeginMode2D(camera);
+        profiler.end(FramePhaseTarget);
+        profiler.begin(FramePhaseDraw);
+        {
+            TRACE_SCOPE("draw");
+            game->draw();
+        }
+        profiler.end(FramePhaseDraw);
+        profiler.begin(FramePhaseTarget);
+        EndMode2D();
+        EndTextureMode();
+        profiler.end(FramePhaseTarget);
+    }
 
     // Draw the game target to the screen
+    profiler.begin(FramePhaseBlit);
     BeginDrawing();
     ClearBackground(BLACK);
 
@@ -40,13 +146,78 @@ void UpdateDrawFrame(void) {
         (Vector2) {
         0, 0
     }, 0.0f, WHITE);
+    profiler.end(FramePhaseBlit);
 
-    EndDrawing();
+    if (showProfiler) {
+        drawProfilerOverlay();
+    }
+
+    bool waitForEvents = false;
+#ifndef EMSCRIPTEN_BUILD
+    // Once nothing is left to do, EndDrawing() sleeps until the next input
+    // event instead of polling at 60 FPS. The profiler overlay keeps the
+    // loop running so its numbers stay live.
+    waitForEvents = !alwaysRedraw && !showProfiler && game->isIdle();
+    if (waitForEvents) {
+        EnableEventWaiting();
+    } else {
+        DisableEventWaiting();
+    }
+#endif
+    profiler.begin(FramePhasePresent);
+    {
+        TRACE_SCOPE("present");
+        EndDrawing();
+    }
+    profiler.end(FramePhasePresent);
+    // A frame that waited for input would only time the wait
+    if (!waitForEvents) {
+        profiler.endFrame();
+    }
+
+    if (!firstFramePresented) {
+        firstFramePresented = true;
+        Trace::instant("first frame");
+        double millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startupBegin).count();
+        TraceLog(LOG_INFO, "Startup to first frame: %.1f ms (cards from %s)", millis,
+                 CardRenderer::isPackLoaded() ? "card pack" : "PNG images");
+    }
 }
 
-int main(void) {
+int main(int argc, char** argv) {
+    startupBegin = std::chrono::steady_clock::now();
+
+    // --deal N starts with game number N instead of a random deal
+    long long dealNumber = -1;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--deal") == 0) {
+            dealNumber = strtoll(argv[i + 1], nullptr, 10);
+        }
+    }
+    // --no-pack decodes the card PNGs even when assets/cards.pack exists
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--no-pack") == 0) {
+            CardRenderer::setUsePack(false);
+        }
+        // --always-redraw draws every frame, as before idle frames were skipped
+        if (strcmp(argv[i], "--always-redraw") == 0) {
+            alwaysRedraw = true;
+        }
+    }
+    // --trace FILE records startup and every frame as Chrome trace events,
+    // written to FILE on exit for Perfetto or chrome://tracing
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--trace") == 0) {
+            Trace::start(argv[i + 1]);
+            Trace::setThreadName("main");
+        }
+    }
+
     // Initialize window with base dimensions first
-    InitWindow(baseWindowWidth, baseWindowHeight, "Solitaire");
+    {
+        TRACE_SCOPE("InitWindow");
+        InitWindow(baseWindowWidth, baseWindowHeight, "Solitaire");
+    }
 #ifndef EMSCRIPTEN_BUILD
     SetWindowState(FLAG_WINDOW_RESIZABLE);
     ToggleBorderlessWindowed();
@@ -60,14 +231,18 @@ int main(void) {
     ClearBackground(BLACK);
     EndDrawing();
 
-    // Set target FPS
-    SetTargetFPS(60);
+    // No SetTargetFPS(): its sleep happens inside EndDrawing() and would count
+    // as present time. The loop below paces itself to 60 FPS instead.
 
     SetExitKey(KEY_NULL);
 
     // Create game instance
     try {
+        TRACE_SCOPE("create game");
         game = new Solitaire();
+        if (dealNumber >= 0 && dealNumber <= UINT32_MAX) {
+            game->newGame(static_cast<uint32_t>(dealNumber));
+        }
     } catch (const std::exception& e) {
         CloseWindow();
         return -1;
@@ -81,10 +256,19 @@ int main(void) {
     emscripten_set_main_loop(UpdateDrawFrame, 0, 1);
 #else
     while (!WindowShouldClose() && !game->shouldExit()) {
+        double frameStart = GetTime();
         UpdateDrawFrame();
+        double remaining = targetFrameSeconds - (GetTime() - frameStart);
+        if (remaining > 0.0) {
+            WaitTime(remaining);
+        }
     }
 #endif
 
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startupBegin).count();
+    TraceLog(LOG_INFO, "Drew %llu of %llu frames, %.2f s CPU in %.1f s", (unsigned long long)loopStats.framesDrawn,
+             (unsigned long long)loopStats.framesPresented, processCpuSeconds(), seconds);
+
     // Cleanup
     if (game) {
         delete game;
@@ -93,5 +277,10 @@ int main(void) {
     
     UnloadRenderTexture(gameTarget);
     CloseWindow();
+
+    // The decode workers were joined with the game, so every buffer is final
+    if (Trace::isEnabled() && !Trace::stop()) {
+        TraceLog(LOG_WARNING, "Could not write the trace file");
+    }
     return 0;
 }
\ No newline at end of file
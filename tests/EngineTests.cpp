@@ -0,0 +1,346 @@
+// Engine regression tests, run by ctest. Each test returns the number of
+// failed checks; the program fails if any test does.
+#include "AutoPlay.h"
+#include "BatchAnalyzer.h"
+#include "DealDatabase.h"
+#include "HintEngine.h"
+#include "Journal.h"
+#include "Klondike.h"
+#include "SaveFormat.h"
+#include "Solver.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(condition)                                                              \
+    do {                                                                              \
+        if (!(condition)) {                                                           \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            failures++;                                                               \
+        }                                                                             \
+    } while (0)
+
+bool sameBoard(const KlondikeState& a, const KlondikeState& b) {
+    SaveImage imageA, imageB;
+    SaveFormat::encode(a, imageA);
+    SaveFormat::encode(b, imageB);
+    return std::memcmp(&imageA, &imageB, sizeof(SaveImage)) == 0;
+}
+
+std::vector<char> readFile(const char* path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const char* path, const char* data, size_t size) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(data, size);
+}
+
+// A draw followed by another move is no longer undone by undoDraw(), the
+// right click on the stock
+void undoDrawAfterOtherMove() {
+    Klondike game;
+    game.newGame(2);
+    CHECK(game.drawFromStock());
+    CHECK(game.canUndoDraw());
+
+    const CardPile& column = game.tableau(3);
+    int target = game.findValidFoundationPile(column.back());
+    CHECK(target != noPile);
+    CHECK(game.tryMove(PileTableau0 + 3, static_cast<int>(column.size()) - 1, target));
+    size_t foundationSize = game.pile(target).size();
+
+    CHECK(!game.canUndoDraw());
+    CHECK(!game.undoDraw());
+    CHECK(game.stock().size() == 23);
+    CHECK(game.pile(target).size() == foundationSize);
+
+    // Once the other move is undone the draw is last again
+    CHECK(game.undo());
+    CHECK(game.undoDraw());
+    CHECK(game.stock().size() == 24);
+    CHECK(game.waste().empty());
+}
+
+// Solved deals played up to the point auto-complete takes over, then run
+// one AutoPlay::playStep() per frame like Solitaire::update(). Auto-complete
+// recycles the waste into the stock, which must not stop it.
+void autoCompleteFrameByFrame() {
+    SolverOptions options;
+    options.nodeBudget = 200000;
+    Solver solver(options);
+    int completed = 0;
+    for (uint32_t seed = 1; seed <= 40; seed++) {
+        Klondike game;
+        game.newGame(seed);
+        SolverResult result = solver.solve(game);
+        if (result.status != SolverSolved) {
+            continue;
+        }
+        size_t next = 0;
+        while (next < result.moves.size() && !AutoPlay::canAutoComplete(game)) {
+            CHECK(game.applyMove(result.moves[next++]));
+        }
+        if (!AutoPlay::canAutoComplete(game)) {
+            continue;
+        }
+        bool completing = false;
+        int frames = 0;
+        while (AutoPlay::playStep(game, completing) && frames < 1000) {
+            frames++;
+        }
+        if (!game.checkWin()) {
+            std::fprintf(stderr, "seed %u: auto-complete stopped after %d frames\n", seed, frames);
+        }
+        CHECK(game.checkWin());
+        completed++;
+    }
+    CHECK(completed > 0);
+}
+
+// Deals the solver once gave up on because talon cards could never go onto
+// column 0, nor foundation cards back onto the column matching their suit
+void solverFindsMissedWins() {
+    Solver solver;
+    const uint32_t seeds[] = {23, 68, 164, 249, 261};
+    for (uint32_t seed : seeds) {
+        Klondike game;
+        game.newGame(seed);
+        SolverResult result = solver.solve(game);
+        if (result.status != SolverSolved) {
+            std::fprintf(stderr, "seed %u: solver status %d\n", seed, static_cast<int>(result.status));
+        }
+        CHECK(result.status == SolverSolved);
+        for (const Move& move : result.moves) {
+            CHECK(game.applyMove(move));
+        }
+        CHECK(game.checkWin());
+    }
+}
+
+// The hint search on a winnable deal ends with a winning line, not with
+// "no winning line found"
+void hintFindsWinningLine() {
+    Klondike game;
+    game.newGame(23);
+    HintEngine engine(30.0);
+    engine.start(game);
+    Hint hint = engine.best();
+    for (int waited = 0; !hint.finished && waited < 60000; waited += 10) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        hint = engine.best();
+    }
+    CHECK(hint.finished);
+    CHECK(hint.valid);
+    CHECK(hint.winning);
+    CHECK(game.applyMove(hint.move));
+}
+
+// A journal written during play, with undos and redos and several keyframes,
+// gives back every state it passed through, by seek() and by stepping
+void journalRoundTrip() {
+    const char* path = "engine-tests-journal.bin";
+    Klondike game;
+    game.newGame(23);
+    SolverResult result = Solver().solve(game);
+    CHECK(result.status == SolverSolved);
+
+    JournalWriter writer;
+    CHECK(writer.open(path, game, 8));
+    game.setJournal(&writer);
+    std::vector<Klondike> states(1, game);
+    for (size_t i = 0; i < result.moves.size() && i < 60; i++) {
+        CHECK(game.applyMove(result.moves[i]));
+        states.push_back(game);
+        if (i % 10 == 9) {
+            CHECK(game.undo());
+            states.push_back(game);
+            CHECK(game.redo());
+            states.push_back(game);
+        }
+    }
+    if (writer.size() % 8 == 0) {
+        CHECK(game.undo());  // End on a move rather than a keyframe, for the torn record below
+        states.push_back(game);
+    }
+    game.setJournal(nullptr);
+    writer.close();
+    CHECK(writer.size() == states.size() - 1);
+
+    JournalReader reader;
+    CHECK(reader.load(path));
+    CHECK(reader.size() == states.size() - 1);
+    CHECK(reader.keyframeCount() > 1);
+    CHECK(reader.mismatchCount() == 0);
+    CHECK(reader.getHeader().dealNumber == 23);
+
+    Klondike replay;
+    for (size_t i = 0; i < states.size(); i++) {
+        CHECK(reader.seek(i, replay));
+        CHECK(sameBoard(replay, states[i]));
+    }
+    CHECK(!reader.seek(states.size(), replay));
+
+    CHECK(reader.seek(0, replay));
+    for (size_t i = 0; i < reader.size(); i++) {
+        reader.step(i, replay);
+    }
+    CHECK(sameBoard(replay, states.back()));
+    for (size_t i = reader.size(); i-- > 0;) {
+        reader.stepBack(i, replay);
+    }
+    CHECK(sameBoard(replay, states.front()));
+
+    // A torn last record, as after a crash mid-write, is dropped
+    std::vector<char> bytes = readFile(path);
+    writeFile(path, bytes.data(), bytes.size() - 2);
+    CHECK(reader.load(path));
+    CHECK(reader.size() == states.size() - 2);
+    std::remove(path);
+}
+
+// A save reads back as the same board, and a truncated or damaged one is
+// refused without touching the game it was read into
+void saveRejectsDamage() {
+    const char* path = "engine-tests-save.bin";
+    Klondike game;
+    game.newGame(99);
+    CHECK(game.drawFromStock());
+    CHECK(SaveFormat::write(path, game));
+
+    Klondike loaded;
+    CHECK(SaveFormat::read(path, loaded));
+    CHECK(sameBoard(loaded, game));
+    CHECK(loaded.getDealNumber() == 99);
+
+    Klondike untouched;
+    untouched.newGame(5);
+    Klondike before = untouched;
+    std::vector<char> bytes = readFile(path);
+    writeFile(path, bytes.data(), bytes.size() - 1);
+    CHECK(!SaveFormat::read(path, untouched));
+    CHECK(sameBoard(untouched, before));
+    std::remove(path);
+
+    SaveImage image;
+    SaveFormat::encode(game, image);
+    SaveImage damaged = image;
+    damaged.cards[10] ^= 0x01;
+    CHECK(!SaveFormat::decode(damaged, untouched));
+
+    // Damage a valid checksum does not catch
+    damaged = image;
+    damaged.cards[1] = damaged.cards[0];
+    damaged.checksum = SaveFormat::checksum(damaged);
+    CHECK(!SaveFormat::decode(damaged, untouched));
+    damaged = image;
+    damaged.pileSizes[PileStock]++;
+    damaged.checksum = SaveFormat::checksum(damaged);
+    CHECK(!SaveFormat::decode(damaged, untouched));
+    damaged = image;
+    damaged.version++;
+    damaged.checksum = SaveFormat::checksum(damaged);
+    CHECK(!SaveFormat::decode(damaged, untouched));
+    CHECK(sameBoard(untouched, before));
+}
+
+// A database built from an analyzer results file finds exactly the solved
+// seeds, its rank table agrees with the records, and a file with a bad
+// size or rank table is refused
+void dealDatabaseLookup() {
+    const char* resultsPath = "engine-tests-results.bin";
+    const char* databasePath = "engine-tests-winnable.db";
+    const uint32_t firstSeed = 1000;
+    const uint32_t count = 300;  // Several bitmap words, the last one partly used
+
+    AnalyzerFileHeader results = {analyzerFileMagic, analyzerFileVersion, sizeof(AnalyzerRecord), firstSeed, count,
+                                  50000, 1, {}};
+    std::vector<AnalyzerRecord> records(count);
+    std::vector<bool> solved(count);
+    for (uint32_t i = 0; i < count; i++) {
+        AnalyzerRecord& record = records[i];
+        record = AnalyzerRecord();
+        record.seed = firstSeed + i;
+        record.status = i % 3 == 0 ? SolverUnsolvable : i % 7 == 0 ? SolverBudgetExceeded : SolverSolved;
+        record.flags = i % 50 == 49 ? 0 : AnalyzerRecord::presentFlag;  // A few left unfinished
+        record.solutionLength = static_cast<uint16_t>(80 + i % 40);
+        solved[i] = record.status == SolverSolved && record.flags != 0;
+    }
+    {
+        std::ofstream file(resultsPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&results), sizeof(results));
+        file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(AnalyzerRecord));
+    }
+
+    DealDatabaseHeader header;
+    CHECK(DealDatabase::build(resultsPath, databasePath, header));
+    DealDatabase database;
+    CHECK(database.open(databasePath));
+    uint32_t expected = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        const DealDatabaseRecord* record = database.find(firstSeed + i);
+        CHECK((record != nullptr) == solved[i]);
+        if (record) {
+            CHECK(record->seed == firstSeed + i);
+            CHECK(record->solutionLength == records[i].solutionLength);
+            expected++;
+        }
+    }
+    CHECK(database.size() == expected);
+    CHECK(database.getHeader().seedCount == count);
+    CHECK(database.find(firstSeed - 1) == nullptr);
+    CHECK(database.find(firstSeed + count) == nullptr);
+    for (uint32_t i = 0; i < database.size(); i++) {
+        CHECK(database.find(database.record(i).seed) == &database.record(i));
+        CHECK(i == 0 || database.record(i - 1).seed < database.record(i).seed);
+    }
+    Xoshiro256 rng(7);
+    uint32_t seed = 0;
+    for (int i = 0; i < 100; i++) {
+        CHECK(database.pick(rng, seed));
+        CHECK(database.find(seed) != nullptr);
+    }
+    database.close();
+
+    std::vector<char> bytes = readFile(databasePath);
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(bytes.data());
+    const DealDatabaseHeader* parsedHeader;
+    const uint64_t* bitmap;
+    const uint32_t* rank;
+    const DealDatabaseRecord* parsedRecords;
+    CHECK(DealDatabase::parse(data, bytes.size(), parsedHeader, bitmap, rank, parsedRecords));
+    CHECK(!DealDatabase::parse(data, bytes.size() - 1, parsedHeader, bitmap, rank, parsedRecords));
+    size_t words = (count + 63) / 64;
+    size_t lastRank = sizeof(DealDatabaseHeader) + words * sizeof(uint64_t) + (words - 1) * sizeof(uint32_t);
+    bytes[lastRank]++;
+    CHECK(!DealDatabase::parse(data, bytes.size(), parsedHeader, bitmap, rank, parsedRecords));
+    std::remove(resultsPath);
+    std::remove(databasePath);
+}
+
+} // namespace
+
+int main() {
+    undoDrawAfterOtherMove();
+    autoCompleteFrameByFrame();
+    solverFindsMissedWins();
+    hintFindsWinningLine();
+    journalRoundTrip();
+    saveRejectsDamage();
+    dealDatabaseLookup();
+    if (failures) {
+        std::fprintf(stderr, "%d checks failed\n", failures);
+        return 1;
+    }
+    std::printf("all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,43 @@
+#pragma once
+// Command line shared by klondike-analyze and klondike-dealdb:
+//
+//   <first-seed> <count> [-o path] [-t threads] [-b node-budget] [-d 1|3]
+#include "BatchAnalyzer.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Reads the seed range and options from argv[1] on into options. -o sets
+// options.outputPath, which keeps its value when the flag is missing. On a
+// bad command line prints usage(argv[0]) or what is wrong and returns false.
+inline bool parseAnalyzerArguments(int argc, char** argv, AnalyzerOptions& options, void (*usage)(const char*)) {
+    if (argc < 3 || argc % 2 == 0) {  // Options come in flag and value pairs
+        usage(argv[0]);
+        return false;
+    }
+    options.firstSeed = static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10));
+    options.count = static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10));
+    for (int i = 3; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "-o") == 0) {
+            options.outputPath = argv[i + 1];
+        } else if (std::strcmp(argv[i], "-t") == 0) {
+            options.threads = static_cast<unsigned>(std::strtoul(argv[i + 1], nullptr, 10));
+        } else if (std::strcmp(argv[i], "-b") == 0) {
+            options.solver.nodeBudget = std::strtoull(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "-d") == 0) {
+            options.drawCount = std::atoi(argv[i + 1]);
+        } else {
+            usage(argv[0]);
+            return false;
+        }
+    }
+    if (options.drawCount != 1 && options.drawCount != 3) {
+        std::fprintf(stderr, "-d takes 1 or 3 cards per draw\n");
+        return false;
+    }
+    if (options.count == 0 || uint64_t(options.firstSeed) + options.count - 1 > UINT32_MAX) {
+        std::fprintf(stderr, "seed range must be non-empty and fit in 32 bits\n");
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,100 @@
+// Winnable deal database builder.
+//
+//   klondike-dealdb <first-seed> <count> [-o winnable.db] [-t threads] [-b node-budget] [-d 1|3]
+//   klondike-dealdb --from results.bin [-o winnable.db]
+//   klondike-dealdb --info winnable.db [seed]
+//
+// Solves every deal in the seed range like klondike-analyze, keeping the
+// results next to the database as <output>.analysis, and writes the seeds
+// the solver won to a database (see DealDatabase.h). --from builds one from
+// an existing klondike-analyze results file instead. --info prints what a
+// database holds, or the entry of one seed.
+#include "AnalyzerArgs.h"
+#include "BatchAnalyzer.h"
+#include "DealDatabase.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace {
+
+void usage(const char* program) {
+    std::fprintf(stderr,
+                 "usage: %s <first-seed> <count> [-o winnable.db] [-t threads] [-b node-budget] [-d 1|3]\n"
+                 "       %s --from results.bin [-o winnable.db]\n"
+                 "       %s --info winnable.db [seed]\n",
+                 program, program, program);
+}
+
+void printHeader(const DealDatabaseHeader& header) {
+    std::printf("seeds            %u to %llu\n", header.firstSeed,
+                (unsigned long long)header.firstSeed + header.seedCount - 1);
+    std::printf("winnable         %u (%.2f%%)\n", header.dealCount,
+                header.seedCount ? 100.0 * header.dealCount / header.seedCount : 0.0);
+    std::printf("cards per draw   %u\n", header.drawCount);
+    std::printf("node budget      %llu\n", (unsigned long long)header.nodeBudget);
+}
+
+int info(int argc, char** argv) {
+    DealDatabase database;
+    if (!database.open(argv[2])) {
+        std::fprintf(stderr, "%s is not a deal database\n", argv[2]);
+        return 1;
+    }
+    if (argc == 3) {
+        printHeader(database.getHeader());
+        return 0;
+    }
+    uint32_t seed = static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10));
+    const DealDatabaseRecord* record = database.find(seed);
+    if (!record) {
+        std::printf("%u not in the database\n", seed);
+        return 1;
+    }
+    std::printf("%u winnable in %u moves\n", seed, record->solutionLength);
+    return 0;
+}
+
+int build(const std::string& resultsPath, const std::string& outputPath) {
+    DealDatabaseHeader header;
+    if (!DealDatabase::build(resultsPath, outputPath, header)) {
+        std::fprintf(stderr, "could not build %s from %s\n", outputPath.c_str(), resultsPath.c_str());
+        return 1;
+    }
+    printHeader(header);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if ((argc == 3 || argc == 4) && std::strcmp(argv[1], "--info") == 0) {
+        return info(argc, argv);
+    }
+
+    std::string outputPath = "winnable.db";
+    if (argc >= 3 && std::strcmp(argv[1], "--from") == 0) {
+        if (argc == 5 && std::strcmp(argv[3], "-o") == 0) {
+            outputPath = argv[4];
+        } else if (argc != 3) {
+            usage(argv[0]);
+            return 1;
+        }
+        return build(argv[2], outputPath);
+    }
+    AnalyzerOptions options;
+    options.outputPath = outputPath;
+    if (!parseAnalyzerArguments(argc, argv, options, usage)) {
+        return 1;
+    }
+    outputPath = options.outputPath;
+    options.outputPath = outputPath + ".analysis";
+    BatchAnalyzer analyzer(options);
+    AnalyzerSummary summary;
+    if (!analyzer.run(summary)) {
+        std::fprintf(stderr, "could not write %s\n", options.outputPath.c_str());
+        return 1;
+    }
+    return build(options.outputPath, outputPath);
+}
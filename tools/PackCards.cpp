@@ -0,0 +1,69 @@
+// Builds the precooked card pack loaded by the game.
+//
+//   pack-cards <assets-dir> <output.pack> [scale]
+//
+// Decodes the 52 faces and the card back under <assets-dir>/cards, scales
+// them to the base card size times scale and writes them as one RGBA8 atlas
+// (see CardPack.h). The game maps the pack and uploads it as is, so none of
+// this work is left for startup.
+#include "CardPack.h"
+#include "Solitaire.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: %s <assets-dir> <output.pack> [scale]\n", argv[0]);
+        return 1;
+    }
+    std::string cardsDir = std::string(argv[1]) + "/cards/";
+    float scale = argc > 3 ? static_cast<float>(std::atof(argv[3])) : 1.0f;
+    if (scale <= 0.0f) {
+        std::fprintf(stderr, "scale must be positive\n");
+        return 1;
+    }
+    SetTraceLogLevel(LOG_WARNING);
+
+    int cellWidth = static_cast<int>(baseCardWidth * scale);
+    int cellHeight = static_cast<int>(baseCardHeight * scale);
+    uint32_t atlasWidth, atlasHeight;
+    CardPack::atlasSize(cellWidth, cellHeight, atlasWidth, atlasHeight);
+    Image atlasImage = GenImageColor(atlasWidth, atlasHeight, BLANK);
+
+    CardPackCell cells[atlasCellCount];
+    int missing = 0;
+    for (int i = 0; i < atlasCellCount; i++) {
+        std::string fileName = "card_back_red.png";
+        if (i != atlasBackCell) {
+            Card card = Card::fromIndex(i);
+            fileName = std::string(card.getValueName()) + "_of_" + card.getSuitName() + ".png";
+        }
+        cells[i] = CardPack::layoutCell(i, cellWidth, cellHeight);
+
+        Image img = LoadImage((cardsDir + fileName).c_str());
+        if (img.data == NULL) {
+            std::fprintf(stderr, "missing %s%s\n", cardsDir.c_str(), fileName.c_str());
+            cells[i].width = 0;
+            cells[i].height = 0;
+            missing++;
+            continue;
+        }
+        ImageResize(&img, cellWidth, cellHeight);
+        Rectangle source = { 0, 0, static_cast<float>(cellWidth), static_cast<float>(cellHeight) };
+        Rectangle dest = { static_cast<float>(cells[i].x), static_cast<float>(cells[i].y), source.width, source.height };
+        ImageDraw(&atlasImage, img, source, dest, WHITE);
+        UnloadImage(img);
+    }
+
+    bool written = CardPack::write(argv[2], scale, atlasWidth, atlasHeight, cells,
+                                   static_cast<const uint8_t*>(atlasImage.data));
+    UnloadImage(atlasImage);
+    if (!written) {
+        std::fprintf(stderr, "could not write %s\n", argv[2]);
+        return 1;
+    }
+    std::printf("%s: %ux%u atlas, %d cards of %dx%d, %d missing\n", argv[2], atlasWidth, atlasHeight,
+                atlasCellCount - missing, cellWidth, cellHeight, missing);
+    return 0;
+}
@@ -0,0 +1,173 @@
+// Replays game journals headless.
+//
+//   klondike-replay <journal> [--at move]
+//   klondike-replay --record <deal> <journal>
+//
+// Without --at the journal is checked and timed: a full replay, seeks to
+// every move compared against the full replay, and the reverse walk back to
+// the start. --at prints the piles after the given number of moves.
+// --record writes the journal of a solver solution, with some undos and
+// redos mixed in, to try the tool without playing a game.
+#include "Journal.h"
+#include "Solver.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+const char rankLetters[] = "?A23456789TJQK";
+const char suitLetters[] = "hdcs";
+
+const char* pileNames[PileCount] = {"T1", "T2", "T3", "T4", "T5", "T6", "T7",
+                                    "F1", "F2", "F3", "F4", "Stock", "Waste"};
+
+void usage(const char* program) {
+    std::fprintf(stderr,
+                 "usage: %s <journal> [--at move]\n"
+                 "       %s --record <deal> <journal>\n",
+                 program, program);
+}
+
+void printGame(const Klondike& game) {
+    for (int p = 0; p < PileCount; p++) {
+        std::printf("%-6s", pileNames[p]);
+        for (Card card : game.pile(p)) {
+            if (card.isFaceUp()) {
+                std::printf(" %c%c", rankLetters[card.getValue()], suitLetters[card.getSuit()]);
+            } else {
+                std::printf(" ##");
+            }
+        }
+        std::printf("\n");
+    }
+}
+
+bool samePiles(const Klondike& a, const Klondike& b) {
+    for (int p = 0; p < PileCount; p++) {
+        if (a.pile(p).size() != b.pile(p).size() ||
+            std::memcmp(a.pile(p).data(), b.pile(p).data(), a.pile(p).size()) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+double millisSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int record(uint32_t deal, const char* path) {
+    Klondike game;
+    game.newGame(deal);
+    SolverResult result = Solver(SolverOptions{}).solve(game);
+    if (result.status != SolverSolved) {
+        std::fprintf(stderr, "deal %u has no solution within the solver budget\n", deal);
+        return 1;
+    }
+
+    JournalWriter journal;
+    if (!journal.open(path, game)) {
+        std::fprintf(stderr, "could not write %s\n", path);
+        return 1;
+    }
+    game.setJournal(&journal);
+    for (size_t i = 0; i < result.moves.size(); i++) {
+        game.applyMove(result.moves[i]);
+        if (i % 10 == 9) {
+            game.undo();
+            game.undo();
+            game.redo();
+            game.redo();
+        }
+    }
+    journal.close();
+    std::printf("deal %u: %zu solution moves, %zu journal records%s\n", deal, result.moves.size(), journal.size(),
+                game.checkWin() ? ", won" : "");
+    return 0;
+}
+
+int check(const JournalReader& journal) {
+    size_t moves = journal.size();
+    std::printf("deal             %u\n", journal.getHeader().dealNumber);
+    std::printf("moves            %zu\n", moves);
+    std::printf("keyframes        %zu (every %u moves)\n", journal.keyframeCount(), journal.getHeader().keyframeInterval);
+    if (journal.mismatchCount() > 0) {
+        std::printf("MISMATCH         %zu keyframes differ from the replayed moves\n", journal.mismatchCount());
+    }
+
+    // Sequential replay, keeping every state for the seek check
+    Klondike game;
+    std::vector<Klondike> states;
+    states.reserve(moves + 1);
+    journal.seek(0, game);
+    states.push_back(game);
+    for (size_t i = 0; i < moves; i++) {
+        journal.step(i, game);
+        states.push_back(game);
+    }
+
+    const int rounds = 20;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        journal.seek(0, game);
+        for (size_t i = 0; i < moves; i++) {
+            journal.step(i, game);
+        }
+    }
+    double replayMs = millisSince(start) / rounds;
+
+    int errors = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i <= moves; i++) {
+        journal.seek(i, game);
+        if (!samePiles(game, states[i])) {
+            errors++;
+        }
+    }
+    double seekMs = millisSince(start);
+
+    journal.seek(moves, game);
+    for (size_t i = moves; i > 0; i--) {
+        journal.stepBack(i - 1, game);
+        if (!samePiles(game, states[i - 1])) {
+            errors++;
+        }
+    }
+
+    std::printf("replay           %.3f ms (%.0f moves/ms)\n", replayMs, replayMs > 0 ? moves / replayMs : 0.0);
+    std::printf("seek             %.2f us average over every move\n", seekMs * 1000.0 / (moves + 1));
+    std::printf("seek/step checks %s\n", errors == 0 ? "ok" : "FAILED");
+    return errors == 0 && journal.mismatchCount() == 0 ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc == 4 && std::strcmp(argv[1], "--record") == 0) {
+        return record(static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)), argv[3]);
+    }
+    if (argc != 2 && !(argc == 4 && std::strcmp(argv[2], "--at") == 0)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    JournalReader journal;
+    if (!journal.load(argv[1])) {
+        std::fprintf(stderr, "%s is not a valid journal\n", argv[1]);
+        return 1;
+    }
+    if (argc == 2) {
+        return check(journal);
+    }
+
+    size_t move = std::strtoull(argv[3], nullptr, 10);
+    Klondike game;
+    if (!journal.seek(move, game)) {
+        std::fprintf(stderr, "the journal has only %zu moves\n", journal.size());
+        return 1;
+    }
+    printGame(game);
+    return 0;
+}